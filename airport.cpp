@@ -30,6 +30,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "airport.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <unordered_set>
 
 namespace NASR
 {
@@ -196,6 +201,72 @@ const std::vector<ILS::RemarksEntry> &AirportImpl::getILSRemarksEntries() const
 
 // ----------------------------------------------------------------------------
 
+AirportView::AirportView(const AirportFileManager &manager, size_t baseRow)
+    : _manager(&manager), _row(baseRow)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AirportView::getRowIndex() const
+{
+    return _row;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::string &AirportView::getIdentifier() const
+{
+    return _manager->_base.getAirportIdentifier(_row);
+}
+
+// ----------------------------------------------------------------------------
+
+const CSV::File &AirportView::getFile(SourceFile file) const
+{
+    return _manager->getSourceFile(file);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan AirportView::getRows(SourceFile file) const
+{
+    return _manager->_airportRows.getRows(static_cast<size_t>(file), _row);
+}
+
+// ----------------------------------------------------------------------------
+
+IAirport::Ptr AirportView::getAirport() const
+{
+    return std::make_shared<AirportImpl>(
+               APT::BaseEntry(_manager->_base.getRow(_row)),
+               getEntries<APT::ArrestingEntry>(SourceFile::APT_ARS),
+               getEntries<APT::AttendanceEntry>(SourceFile::APT_ATT),
+               getEntries<APT::ContactEntry>(SourceFile::APT_CON),
+               getEntries<APT::RemarksEntry>(SourceFile::APT_RMK),
+               getEntries<APT::RunwayEntry>(SourceFile::APT_RWY),
+               getEntries<APT::RunwayEndEntry>(SourceFile::APT_RWY_END),
+               getEntries<ILS::BaseEntry>(SourceFile::ILS_BASE),
+               getEntries<ILS::GlideslopeEntry>(SourceFile::ILS_GS),
+               getEntries<ILS::DMEEntry>(SourceFile::ILS_DME),
+               getEntries<ILS::MarkerEntry>(SourceFile::ILS_MKR),
+               getEntries<ILS::RemarksEntry>(SourceFile::ILS_RMK));
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::vector<std::string>> WithAirportIndex(std::vector<std::vector<std::string>> indexes)
+{
+    const std::vector<std::string> airport{ "ARPT_ID" };
+    if (std::find(indexes.begin(), indexes.end(), airport) == indexes.end())
+    {
+        indexes.push_back(airport);
+    }
+    return indexes;
+}
+
+// ----------------------------------------------------------------------------
+
 AirportFile::AirportFile()
     : CSV::File()
 {
@@ -203,8 +274,8 @@ AirportFile::AirportFile()
 
 // ----------------------------------------------------------------------------
 
-AirportFile::AirportFile(const std::string &filename)
-    : CSV::File(filename)
+AirportFile::AirportFile(const std::string &filename, const std::vector<std::vector<std::string>> &indexes)
+    : CSV::File(filename, WithAirportIndex(indexes))
 {
     _cachedColumns.emplace("ARPT_ID", getColumn("ARPT_ID"));
 }
@@ -218,9 +289,17 @@ std::vector<std::string> AirportFile::getAirportIdentifiers() const
 
 // ----------------------------------------------------------------------------
 
+const std::string &AirportFile::getAirportIdentifier(size_t rowIndex) const
+{
+    return _cachedColumns.at("ARPT_ID").get()[rowIndex];
+}
+
+// ----------------------------------------------------------------------------
+
 std::vector<size_t> AirportFile::getAirportRowIndices(const std::string &locationIdentifier) const
 {
-    return _cachedColumns.at("ARPT_ID").where(locationIdentifier);
+    const CSV::RowSpan rows = lookup("ARPT_ID", locationIdentifier);
+    return std::vector<size_t>(rows.begin(), rows.end());
 }
 
 // ----------------------------------------------------------------------------
@@ -240,6 +319,42 @@ const CSV::Column &AirportFile::getCachedColumn(const std::string &name)
 
 // ----------------------------------------------------------------------------
 
+const CSV::Column &AirportFile::getCachedColumn(const std::string &name) const
+{
+    return _cachedColumns.at(name);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<Data::LatitudeLongitude> AirportFile::getLocations(const std::string &latitudeColumn, const std::string &longitudeColumn) const
+{
+    std::vector<Data::LatitudeLongitude> out;
+    if (!isValid())
+    {
+        return out;
+    }
+
+    const CSV::Column latitudes = getColumn(latitudeColumn);
+    const CSV::Column longitudes = getColumn(longitudeColumn);
+    out.reserve(latitudes.get().size());
+    for (size_t i = 0; i < latitudes.get().size(); i++)
+    {
+        const tl::optional<double> latitude = CSV::Utils::ParseOptional<double>(latitudes.get()[i]);
+        const tl::optional<double> longitude = CSV::Utils::ParseOptional<double>(longitudes.get()[i]);
+        if (latitude && longitude)
+        {
+            out.emplace_back(*latitude, *longitude);
+        }
+        else
+        {
+            out.emplace_back();
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
 std::string Join(const std::string &base, const std::string &filename)
 {
     // todo: do more about stripping extra \ or / characters
@@ -254,10 +369,10 @@ AirportFileManager::AirportFileManager()
 
 // ----------------------------------------------------------------------------
 
-AirportFileManager::AirportFileManager(const std::string &directory)
+AirportFileManager::AirportFileManager(const std::string &directory, bool indexRemarks)
     : _directory(directory)
 {
-    loadFrom(directory);
+    loadFrom(directory, indexRemarks);
 }
 
 // ----------------------------------------------------------------------------
@@ -280,25 +395,284 @@ bool AirportFileManager::isInitialized() const
 
 // ----------------------------------------------------------------------------
 
-void AirportFileManager::loadFrom(const std::string &csvDirectory)
+void AirportFileManager::loadFrom(const std::string &csvDirectory, bool indexRemarks)
 {
     _directory = csvDirectory;
 
-    // load APT files
-    _base = AirportFile(Join(csvDirectory, "APT_BASE.csv"));
-    _arresting = AirportFile(Join(csvDirectory, "APT_ARS.csv"));
-    _attendance = AirportFile(Join(csvDirectory, "APT_ATT.csv"));
-    _contact = AirportFile(Join(csvDirectory, "APT_CON.csv"));
-    _remarks = AirportFile(Join(csvDirectory, "APT_RMK.csv"));
-    _runway = AirportFile(Join(csvDirectory, "APT_RWY.csv"));
-    _runwayEnds = AirportFile(Join(csvDirectory, "APT_RWY_END.csv"));
+    // files are parsed concurrently, each building the hash indexes declared
+    // for it while it is parsed (ARPT_ID is always indexed)
+    struct FileLoad
+    {
+        AirportFile *file;
+        const char *filename;
+        std::vector<std::vector<std::string>> indexes;
+        std::vector<std::string> numericIndexes;
+    };
+    const std::vector<FileLoad> loads
+    {
+        // APT files
+        { &_base, "APT_BASE.csv", { { "SITE_NO" } }, { "ELEV", "BASED_SINGLE_ENG", "BASED_MULTI_ENG", "BASED_JET_ENG" } },
+        { &_arresting, "APT_ARS.csv", { RunwayJoinTable::RUNWAY_END_KEY }, {} },
+        { &_attendance, "APT_ATT.csv", {}, {} },
+        { &_contact, "APT_CON.csv", {}, {} },
+        { &_remarks, "APT_RMK.csv", {}, {} },
+        { &_runway, "APT_RWY.csv", { RunwayJoinTable::RUNWAY_KEY }, { "RWY_LEN" } },
+        { &_runwayEnds, "APT_RWY_END.csv", { { "ARPT_ID", "RWY_ID" }, ILSSystemTable::RUNWAY_END_KEY }, {} },
+
+        // ILS files
+        { &_ilsBase, "ILS_BASE.csv", { { "ILS_LOC_ID" } }, {} },
+        { &_glideslope, "ILS_GS.csv", { { "ILS_LOC_ID" }, ILSSystemTable::COMPONENT_KEY }, {} },
+        { &_dme, "ILS_DME.csv", { { "ILS_LOC_ID" }, ILSSystemTable::COMPONENT_KEY }, {} },
+        { &_marker, "ILS_MKR.csv", { { "ILS_LOC_ID" }, ILSSystemTable::COMPONENT_KEY }, {} },
+        { &_ilsRemarks, "ILS_RMK.csv", { { "ILS_LOC_ID" }, ILSSystemTable::COMPONENT_KEY }, {} }
+    };
+    // a malformed file (e.g. missing an indexed column) fails the load on this thread once every file is done
+    std::vector<std::exception_ptr> failures(loads.size());
+    Parallel::For(loads.size(), 0, [&loads, &failures, &csvDirectory](size_t begin, size_t end, size_t)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const FileLoad &load = loads[i];
+            try
+            {
+                *load.file = AirportFile(Join(csvDirectory, load.filename), load.indexes);
+                if (load.file->isValid())
+                {
+                    for (const std::string &column : load.numericIndexes)
+                    {
+                        load.file->addNumericIndex(column);
+                    }
+                }
+            }
+            catch (...)
+            {
+                failures[i] = std::current_exception();
+            }
+        }
+    });
+    for (const std::exception_ptr &failure : failures)
+    {
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    buildSpatialIndexes();
+    _airportRows = AirportRowGroups(_base, getSourceFiles());
+    if (_base.isValid())
+    {
+        _airportIdentifiers = IdentifierIndex(_base.getCachedColumn("ARPT_ID").get());
+        _icaoIdentifiers = IdentifierIndex(_base.getCachedColumn("ICAO_ID").get());
+
+        std::vector<std::string> identifiers = _base.getAirportIdentifiers();
+        const size_t airportCount = identifiers.size();
+        const std::vector<std::string> &icao = _base.getCachedColumn("ICAO_ID").get();
+        identifiers.insert(identifiers.end(), icao.begin(), icao.end());
+
+        // most airports have no ICAO_ID; an empty key would only make "" a member
+        std::vector<std::string> filterKeys;
+        filterKeys.reserve(identifiers.size());
+        for (const std::string &identifier : identifiers)
+        {
+            if (!identifier.empty())
+            {
+                filterKeys.push_back(identifier);
+            }
+        }
+        _identifierFilter = BloomFilter(filterKeys);
+        std::vector<size_t> rows(identifiers.size());
+        for (size_t i = 0; i < rows.size(); i++)
+        {
+            rows[i] = i % airportCount;
+        }
+        _fuzzyIdentifiers = FuzzyIndex(identifiers, rows);
+        _fuzzyNames = FuzzyIndex(_base.getColumn("ARPT_NAME").get());
+    }
+    _runwayWindTable = RunwayWindTable(_base, _runway, _runwayEnds);
+    _runwayJoin = RunwayJoinTable(_base, _runway, _runwayEnds, _arresting);
+    _ilsSystems = _ilsBase.isValid() ? ILSSystemTable(_ilsBase, _glideslope, _dme, _marker, _ilsRemarks, _runwayEnds) : ILSSystemTable();
+    _ilsBeams = ILSBeamTable(_ilsSystems, _ilsBase, _glideslope, _runwayEnds);
+    _runwayHeadings = RunwayHeadingTable(_runwayJoin, _runwayWindTable, _base, _ilsBase, _ilsSystems);
+    buildFrequencyIndex();
+    _remarkGroups = _remarks.isValid() ? RemarkGroupTable(_remarks) : RemarkGroupTable();
+    _query = QueryEngine();
+    _ranking = AirportRanking(_base, _runway);
+    _attendanceTable = AttendanceTable(_base, _attendance);
+    _solarLighting = SolarLightingTable(_base);
+
+    // names weigh more than cities, cities more than counties
+    if (_base.isValid())
+    {
+        _airportNames = TrigramIndex({ _base.getColumn("ARPT_NAME").get(), _base.getColumn("CITY").get(), _base.getColumn("COUNTY_NAME").get() }, { 3.0, 2.0, 1.0 });
+    }
+
+    _airportRemarkIndex.reset();
+    _ilsRemarkIndex.reset();
+    if (indexRemarks)
+    {
+        buildRemarkIndexes();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void AirportFileManager::buildFrequencyIndex()
+{
+    std::vector<FrequencyIndex::Entry> entries;
+    if (!_ilsBase.isValid())
+    {
+        _frequencies = FrequencyIndex();
+        return;
+    }
+
+    const CSV::Column localizerFrequencies = _ilsBase.getColumn("LOC_FREQ");
+    const std::vector<Data::LatitudeLongitude> localizerLocations = _ilsBase.getLocations();
+    for (size_t row = 0; row < localizerLocations.size(); row++)
+    {
+        const tl::optional<uint32_t> frequency = FrequencyIndex::ParseFrequency(localizerFrequencies.get()[row]);
+        if (frequency && localizerLocations[row].valid())
+        {
+            entries.push_back({ *frequency, NavaidComponent::LOCALIZER, static_cast<uint32_t>(row), localizerLocations[row] });
+        }
+    }
+
+    // glideslopes and DMEs are listed under their own frequency and, when it differs,
+    // under the frequency of the localizer they are paired with
+    std::vector<tl::optional<uint32_t>> glideslopeTuning;
+    std::vector<tl::optional<uint32_t>> dmeTuning;
+    for (size_t index = 0; index < _ilsSystems.size(); index++)
+    {
+        const ILSSystem &system = _ilsSystems.getSystem(index);
+        const tl::optional<uint32_t> frequency = FrequencyIndex::ParseFrequency(localizerFrequencies.get()[system.localizerRow]);
+        if (system.glideslopeRow != ILSSystem::NO_ROW)
+        {
+            glideslopeTuning.resize(std::max<size_t>(glideslopeTuning.size(), system.glideslopeRow + 1));
+            glideslopeTuning[system.glideslopeRow] = frequency;
+        }
+        if (system.dmeRow != ILSSystem::NO_ROW)
+        {
+            dmeTuning.resize(std::max<size_t>(dmeTuning.size(), system.dmeRow + 1));
+            dmeTuning[system.dmeRow] = frequency;
+        }
+    }
+
+    const auto addComponent = [&entries](NavaidComponent component, const AirportFile &file, const std::string &column, const std::vector<tl::optional<uint32_t>> &localizerTuning, tl::optional<uint32_t> (*parse)(const std::string &))
+    {
+        if (!file.isValid())
+        {
+            return;
+        }
+        const CSV::Column values = file.getColumn(column);
+        const std::vector<Data::LatitudeLongitude> locations = file.getLocations();
+        for (size_t row = 0; row < locations.size(); row++)
+        {
+            if (!locations[row].valid())
+            {
+                continue;
+            }
+            const tl::optional<uint32_t> frequency = parse(values.get()[row]);
+            if (frequency)
+            {
+                entries.push_back({ *frequency, component, static_cast<uint32_t>(row), locations[row] });
+            }
+            if (row < localizerTuning.size() && localizerTuning[row] && localizerTuning[row] != frequency)
+            {
+                entries.push_back({ *localizerTuning[row], component, static_cast<uint32_t>(row), locations[row] });
+            }
+        }
+    };
+    addComponent(NavaidComponent::GLIDESLOPE, _glideslope, "G_S_FREQ", glideslopeTuning, &FrequencyIndex::ParseFrequency);
+    addComponent(NavaidComponent::DME, _dme, "CHANNEL", dmeTuning, &FrequencyIndex::ParseChannel);
+    addComponent(NavaidComponent::MARKER, _marker, "FREQ", std::vector<tl::optional<uint32_t>>(), &FrequencyIndex::ParseKilohertz);
+
+    _frequencies = FrequencyIndex(std::move(entries));
+}
+
+// ----------------------------------------------------------------------------
+
+void AirportFileManager::buildSpatialIndexes()
+{
+    _airportLocations = SpatialIndex(_base.getLocations());
+    _runwayEndLocations = SpatialIndex(_runwayEnds.getLocations());
+    _ilsLocations = SpatialIndex(_ilsBase.getLocations());
+    _markerLocations = SpatialIndex(_marker.getLocations());
+
+    // identifier columns used when reporting facilities
+    if (_runwayEnds.isValid())
+    {
+        _runwayEnds.getCachedColumn("RWY_END_ID");
+    }
+    if (_ilsBase.isValid())
+    {
+        _ilsBase.getCachedColumn("ILS_LOC_ID");
+    }
+    if (_marker.isValid())
+    {
+        _marker.getCachedColumn("ILS_LOC_ID");
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+const AirportFile &AirportFileManager::getFacilityFile(FacilityType type) const
+{
+    switch (type)
+    {
+    case FacilityType::RUNWAY_END:
+        return _runwayEnds;
+    case FacilityType::ILS:
+        return _ilsBase;
+    case FacilityType::MARKER:
+        return _marker;
+    case FacilityType::AIRPORT:
+    default:
+        return _base;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+const SpatialIndex &AirportFileManager::getSpatialIndex(FacilityType type) const
+{
+    switch (type)
+    {
+    case FacilityType::RUNWAY_END:
+        return _runwayEndLocations;
+    case FacilityType::ILS:
+        return _ilsLocations;
+    case FacilityType::MARKER:
+        return _markerLocations;
+    case FacilityType::AIRPORT:
+    default:
+        return _airportLocations;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+FacilityEntry AirportFileManager::makeFacilityEntry(FacilityType type, size_t rowIndex) const
+{
+    const AirportFile &file = getFacilityFile(type);
+    const std::string &airportIdentifier = file.getAirportIdentifier(rowIndex);
 
-    // load ILS files
-    _ilsBase = AirportFile(Join(csvDirectory, "ILS_BASE.csv"));
-    _glideslope = AirportFile(Join(csvDirectory, "ILS_GS.csv"));
-    _dme = AirportFile(Join(csvDirectory, "ILS_DME.csv"));
-    _marker = AirportFile(Join(csvDirectory, "ILS_MKR.csv"));
-    _ilsRemarks = AirportFile(Join(csvDirectory, "ILS_RMK.csv"));
+    std::string facilityIdentifier;
+    switch (type)
+    {
+    case FacilityType::RUNWAY_END:
+        facilityIdentifier = file.getCachedColumn("RWY_END_ID").get()[rowIndex];
+        break;
+    case FacilityType::ILS:
+    case FacilityType::MARKER:
+        facilityIdentifier = file.getCachedColumn("ILS_LOC_ID").get()[rowIndex];
+        break;
+    case FacilityType::AIRPORT:
+    default:
+        facilityIdentifier = airportIdentifier;
+        break;
+    }
+
+    return { type, airportIdentifier, facilityIdentifier, rowIndex, getSpatialIndex(type).getPoint(rowIndex) };
 }
 
 // ----------------------------------------------------------------------------
@@ -317,16 +691,40 @@ std::vector<std::string> AirportFileManager::getAirportIdentifiers() const
 
 // ----------------------------------------------------------------------------
 
+bool AirportFileManager::isFilterMember(const std::string &identifier) const
+{
+    return !identifier.empty() && (!_airportIdentifiers.find(identifier).empty() || !_icaoIdentifiers.find(identifier).empty());
+}
+
+// ----------------------------------------------------------------------------
+
 IAirport::Ptr AirportFileManager::getAirport(const std::string &identifier) const
 {
-    std::vector<size_t> baseIndices = _base.getAirportRowIndices(identifier);
-    if (baseIndices.size() != 1)
+    if (!_identifierFilter.mayContain(identifier))
+    {
+        return nullptr;
+    }
+
+    tl::optional<size_t> baseIndex = _airportIdentifiers.findRow(identifier);
+    if (!baseIndex)
     {
+        // the filter also holds ICAO_ID, so only identifiers in neither index are false positives
+        if (!isFilterMember(identifier))
+        {
+            _identifierFilter.recordFalsePositive();
+        }
         return nullptr;
     }
+    return makeAirport(*baseIndex);
+}
+
+// ----------------------------------------------------------------------------
 
+IAirport::Ptr AirportFileManager::makeAirport(size_t baseRow) const
+{
+    const std::string &identifier = _base.getAirportIdentifier(baseRow);
     return std::make_shared<AirportImpl>(
-               APT::BaseEntry(_base.getRow(baseIndices[0])),
+               APT::BaseEntry(_base.getRow(baseRow)),
                getEntriesForAirport<APT::ArrestingEntry>(_arresting, identifier),
                getEntriesForAirport<APT::AttendanceEntry>(_attendance, identifier),
                getEntriesForAirport<APT::ContactEntry>(_contact, identifier),
@@ -342,14 +740,602 @@ IAirport::Ptr AirportFileManager::getAirport(const std::string &identifier) cons
 
 // ----------------------------------------------------------------------------
 
+void AirportFileManager::forEachAirport(const std::function<void(const AirportView &)> &callback, size_t parallelism) const
+{
+    Parallel::ForDynamic(_airportRows.getAirportCount(), 256, parallelism, [this, &callback](size_t begin, size_t end, size_t)
+    {
+        for (size_t row = begin; row < end; row++)
+        {
+            callback(AirportView(*this, row));
+        }
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+void AirportFileManager::forEachAirport(const std::function<void(const AirportView &)> &callback, const Parallel::Executor &executor, size_t chunkSize) const
+{
+    chunkSize = std::max<size_t>(1, chunkSize);
+    const size_t count = _airportRows.getAirportCount();
+    std::vector<std::function<void()>> tasks;
+    for (size_t begin = 0; begin < count; begin += chunkSize)
+    {
+        const size_t end = std::min(count, begin + chunkSize);
+        tasks.push_back([this, &callback, begin, end]()
+        {
+            for (size_t row = begin; row < end; row++)
+            {
+                callback(AirportView(*this, row));
+            }
+        });
+    }
+    executor(tasks);
+}
+
+// ----------------------------------------------------------------------------
+
 IAirport::Ptr AirportFileManager::getAirportByICAO(const std::string &identifier)
 {
-    std::vector<size_t> indices = _base.getCachedColumn("ICAO_ID").where(identifier);
-    if (indices.size() == 1)
+    // one filter check covers both the ICAO and the FAA identifier probes
+    if (!_identifierFilter.mayContain(identifier))
+    {
+        return nullptr;
+    }
+
+    tl::optional<size_t> index = _icaoIdentifiers.findRow(identifier);
+    if (!index)
+    {
+        index = _airportIdentifiers.findRow(identifier);
+    }
+    if (!index)
+    {
+        if (!isFilterMember(identifier))
+        {
+            _identifierFilter.recordFalsePositive();
+        }
+        return nullptr;
+    }
+    return makeAirport(*index);
+}
+
+// ----------------------------------------------------------------------------
+
+BloomFilterStatistics AirportFileManager::getIdentifierFilterStatistics() const
+{
+    return _identifierFilter.getStatistics();
+}
+
+// ----------------------------------------------------------------------------
+
+const IdentifierIndex &AirportFileManager::getAirportIdentifierIndex() const
+{
+    return _airportIdentifiers;
+}
+
+// ----------------------------------------------------------------------------
+
+const IdentifierIndex &AirportFileManager::getICAOIdentifierIndex() const
+{
+    return _icaoIdentifiers;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RouteCorridorEntry> AirportFileManager::getFacilitiesAlongRoute(const std::vector<Data::LatitudeLongitude> &route, double halfWidth, bool includeILS) const
+{
+    std::vector<RouteCorridorEntry> out;
+
+    std::vector<FacilityType> types{ FacilityType::AIRPORT };
+    if (includeILS)
+    {
+        types.push_back(FacilityType::ILS);
+    }
+
+    for (FacilityType type : types)
+    {
+        for (const CorridorHit &hit : getSpatialIndex(type).queryCorridor(route, halfWidth))
+        {
+            out.push_back({ makeFacilityEntry(type, hit.index), hit.alongTrackDistance, hit.crossTrackDistance });
+        }
+    }
+
+    std::stable_sort(out.begin(), out.end(), [](const RouteCorridorEntry &a, const RouteCorridorEntry &b)
+    {
+        return a.alongTrackDistance < b.alongTrackDistance;
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<FacilityEntry> AirportFileManager::getFacilitiesInPolygon(const std::vector<Data::LatitudeLongitude> &polygon) const
+{
+    return getFacilitiesInPolygon(Geo::Polygon(polygon), { FacilityType::AIRPORT, FacilityType::RUNWAY_END, FacilityType::MARKER });
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<FacilityEntry> AirportFileManager::getFacilitiesInPolygon(const Geo::Polygon &polygon, const std::vector<FacilityType> &types) const
+{
+    std::vector<FacilityEntry> out;
+    for (FacilityType type : types)
+    {
+        for (size_t rowIndex : getSpatialIndex(type).queryPolygon(polygon))
+        {
+            out.push_back(makeFacilityEntry(type, rowIndex));
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<FacilityPair> AirportFileManager::getFacilityPairsWithin(FacilityType type, double distance, const std::string &keyColumn, size_t threads) const
+{
+    std::vector<FacilityPair> out;
+    const AirportFile &file = getFacilityFile(type);
+    if (!file.isValid())
+    {
+        return out;
+    }
+
+    const SpatialIndex &index = getSpatialIndex(type);
+    const std::vector<SpatialPair> pairs = keyColumn.empty() ? index.selfJoin(distance, threads) : index.selfJoinOnKey(distance, file.getColumn(keyColumn).get(), threads);
+
+    out.reserve(pairs.size());
+    for (const SpatialPair &pair : pairs)
+    {
+        out.push_back({ makeFacilityEntry(type, pair.first), makeFacilityEntry(type, pair.second), pair.distance });
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<FacilityPair> AirportFileManager::getILSFrequencyConflicts(double distance, size_t threads) const
+{
+    return getFacilityPairsWithin(FacilityType::ILS, distance, "LOC_FREQ", threads);
+}
+
+// ----------------------------------------------------------------------------
+
+AirportGraph AirportFileManager::buildAirportGraph(double range, const RunwayCriteria &criteria, size_t threads) const
+{
+    if (!_base.isValid() || !_runway.isValid())
+    {
+        return AirportGraph();
+    }
+
+    const std::vector<std::string> &identifiers = _base.getCachedColumn("ARPT_ID").get();
+
+    // an airport is eligible if any one of its runways meets the criteria
+    std::vector<bool> eligible(identifiers.size(), false);
+    const std::vector<std::string> &runwayAirports = _runway.getCachedColumn("ARPT_ID").get();
+    const CSV::Column surfaces = _runway.getColumn("SURFACE_TYPE_CODE");
+    for (uint32_t row : _runway.getNumericIndex("RWY_LEN").atLeast(criteria.minimumLength))
+    {
+        if (criteria.pavedOnly && !APT::IsPavedSurfaceCode(surfaces.get()[row]))
+        {
+            continue;
+        }
+        for (uint32_t airport : _base.lookup("ARPT_ID", runwayAirports[row]))
+        {
+            eligible[airport] = true;
+        }
+    }
+
+    return AirportGraph(_airportLocations, identifiers, eligible, range, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::string> AirportFileManager::getAirportIdentifiersInRange(const std::string &column, double minimum, double maximum) const
+{
+    std::vector<size_t> rows;
+    if (_base.hasNumericIndex(column))
+    {
+        const CSV::RowSpan span = _base.getNumericIndex(column).between(minimum, maximum);
+        rows.assign(span.begin(), span.end());
+    }
+    else
+    {
+        // runway columns select every airport with at least one matching runway
+        for (uint32_t runway : _runway.getNumericIndex(column).between(minimum, maximum))
+        {
+            const CSV::RowSpan airports = _base.lookup("ARPT_ID", _runway.getAirportIdentifier(runway));
+            rows.insert(rows.end(), airports.begin(), airports.end());
+        }
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    std::vector<std::string> out;
+    out.reserve(rows.size());
+    for (size_t row : rows)
+    {
+        out.push_back(_base.getAirportIdentifier(row));
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> AirportFileManager::selectRows(SourceFile file, const Predicate &predicate, size_t threads) const
+{
+    return _query.select(getSourceFiles(), file, predicate, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<IAirport::Ptr> AirportFileManager::selectAirports(const Predicate &predicate, size_t threads) const
+{
+    std::vector<IAirport::Ptr> out;
+    for (size_t row : selectRows(SourceFile::APT_BASE, predicate, threads))
+    {
+        out.push_back(makeAirport(row));
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<AggregateGroup> AirportFileManager::aggregate(SourceFile file, const std::vector<std::string> &groupBy, const std::vector<Aggregation> &aggregations, size_t threads) const
+{
+    return _query.aggregate(getSourceFiles(), file, groupBy, aggregations, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<AggregateGroup> AirportFileManager::aggregate(SourceFile file, const Predicate &predicate, const std::vector<std::string> &groupBy, const std::vector<Aggregation> &aggregations, size_t threads) const
+{
+    return _query.aggregate(getSourceFiles(), file, predicate, groupBy, aggregations, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+JoinedView AirportFileManager::joinFiles(SourceFile left, const std::vector<std::string> &leftColumns, SourceFile right, const std::vector<std::string> &rightColumns, size_t threads) const
+{
+    const CSV::File &leftFile = getSourceFile(left);
+    const CSV::File &rightFile = getSourceFile(right);
+    return JoinedView(leftFile, rightFile, HashJoin(leftFile, leftColumns, rightFile, rightColumns, threads));
+}
+
+// ----------------------------------------------------------------------------
+
+const AirportFile &AirportFileManager::getSourceFile(SourceFile file) const
+{
+    switch (file)
+    {
+    case SourceFile::APT_ARS:
+        return _arresting;
+    case SourceFile::APT_ATT:
+        return _attendance;
+    case SourceFile::APT_CON:
+        return _contact;
+    case SourceFile::APT_RMK:
+        return _remarks;
+    case SourceFile::APT_RWY:
+        return _runway;
+    case SourceFile::APT_RWY_END:
+        return _runwayEnds;
+    case SourceFile::ILS_BASE:
+        return _ilsBase;
+    case SourceFile::ILS_GS:
+        return _glideslope;
+    case SourceFile::ILS_DME:
+        return _dme;
+    case SourceFile::ILS_MKR:
+        return _marker;
+    case SourceFile::ILS_RMK:
+        return _ilsRemarks;
+    case SourceFile::APT_BASE:
+    default:
+        return _base;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<const CSV::File *> AirportFileManager::getSourceFiles() const
+{
+    // in SourceFile order
+    return
+    {
+        &_base, &_arresting, &_attendance, &_contact, &_remarks, &_runway, &_runwayEnds,
+        &_ilsBase, &_glideslope, &_dme, &_marker, &_ilsRemarks
+    };
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RankedAirport> AirportFileManager::getTopAirports(AirportMetric metric, size_t k) const
+{
+    return makeRankedAirports(_ranking.top(metric, k));
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RankedAirport> AirportFileManager::getTopAirports(AirportMetric metric, size_t k, const Geo::BoundingBox &box) const
+{
+    return makeRankedAirports(_ranking.top(metric, k, _airportLocations.queryBoundingBox(box)));
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RankedAirport> AirportFileManager::getTopAirports(AirportMetric metric, size_t k, const Data::LatitudeLongitude &center, double radius) const
+{
+    std::vector<size_t> rows;
+    for (const SpatialHit &hit : _airportLocations.queryRadius(center, radius))
+    {
+        rows.push_back(hit.index);
+    }
+    return makeRankedAirports(_ranking.top(metric, k, rows));
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RankedAirport> AirportFileManager::makeRankedAirports(const std::vector<RankedRow> &rows) const
+{
+    std::vector<RankedAirport> out;
+    out.reserve(rows.size());
+    for (const RankedRow &row : rows)
+    {
+        out.push_back({ _base.getAirportIdentifier(row.row), row.row, row.value });
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+const AirportRanking &AirportFileManager::getAirportRanking() const
+{
+    return _ranking;
+}
+
+// ----------------------------------------------------------------------------
+
+const RunwayJoinTable &AirportFileManager::getRunwayJoinTable() const
+{
+    return _runwayJoin;
+}
+
+// ----------------------------------------------------------------------------
+
+bool AirportFileManager::isAttendedAt(const std::string &airportIdentifier, const std::tm &localTime) const
+{
+    const tl::optional<size_t> baseIndex = _airportIdentifiers.findRow(airportIdentifier);
+    return baseIndex && _attendanceTable.isAttendedAt(*baseIndex, localTime);
+}
+
+// ----------------------------------------------------------------------------
+
+const AttendanceTable &AirportFileManager::getAttendanceTable() const
+{
+    return _attendanceTable;
+}
+
+// ----------------------------------------------------------------------------
+
+void AirportFileManager::computeAirportLighting(std::time_t utc, std::vector<uint8_t> &out) const
+{
+    _solarLighting.computeLighting(utc, out);
+}
+
+// ----------------------------------------------------------------------------
+
+const SolarLightingTable &AirportFileManager::getSolarLightingTable() const
+{
+    return _solarLighting;
+}
+
+// ----------------------------------------------------------------------------
+
+const RunwayHeadingTable &AirportFileManager::getRunwayHeadingTable() const
+{
+    return _runwayHeadings;
+}
+
+// ----------------------------------------------------------------------------
+
+const RunwayWindTable &AirportFileManager::getRunwayWindTable() const
+{
+    return _runwayWindTable;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<ILSApproach> AirportFileManager::getILSApproaches(const std::string &airportIdentifier, const std::string &runwayEnd) const
+{
+    std::vector<ILSApproach> out;
+    if (!_runwayEnds.isValid() || !_ilsBase.isValid())
+    {
+        return out;
+    }
+
+    for (uint32_t endRow : _runwayEnds.lookupComposite(ILSSystemTable::RUNWAY_END_KEY, { airportIdentifier, runwayEnd }))
+    {
+        for (uint32_t index : _ilsSystems.getSystemsForRunwayEnd(endRow))
+        {
+            const ILSSystem &system = _ilsSystems.getSystem(index);
+            ILSApproach approach{ ILS::BaseEntry(_ilsBase.getRow(system.localizerRow)), APT::RunwayEndEntry(_runwayEnds.getRow(endRow)), tl::nullopt, tl::nullopt, {}, {} };
+            if (system.glideslopeRow != ILSSystem::NO_ROW)
+            {
+                approach.glideslope = ILS::GlideslopeEntry(_glideslope.getRow(system.glideslopeRow));
+            }
+            if (system.dmeRow != ILSSystem::NO_ROW)
+            {
+                approach.dme = ILS::DMEEntry(_dme.getRow(system.dmeRow));
+            }
+            for (uint32_t row : _ilsSystems.getMarkerRows(index))
+            {
+                approach.markers.emplace_back(_marker.getRow(row));
+            }
+            for (uint32_t row : _ilsSystems.getRemarkRows(index))
+            {
+                approach.remarks.emplace_back(_ilsRemarks.getRow(row));
+            }
+            out.push_back(std::move(approach));
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<APT::RemarksEntry> AirportFileManager::getRemarks(const std::string &airportIdentifier, APT::RemarksTable table) const
+{
+    std::vector<APT::RemarksEntry> out;
+    for (uint32_t row : _remarkGroups.getRemarkRows(airportIdentifier, table))
+    {
+        out.emplace_back(_remarks.getRow(row));
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<APT::RemarksEntry> AirportFileManager::getRemarks(const std::string &airportIdentifier, APT::RemarksTable table, const std::string &element) const
+{
+    std::vector<APT::RemarksEntry> out;
+    for (uint32_t row : _remarkGroups.getRemarkRows(airportIdentifier, table, element))
+    {
+        out.emplace_back(_remarks.getRow(row));
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+const RemarkGroupTable &AirportFileManager::getRemarkGroupTable() const
+{
+    return _remarkGroups;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<TunedFacility> AirportFileManager::getTunedFacilities(const std::string &tuning, const Data::LatitudeLongitude &position, double range) const
+{
+    const tl::optional<uint32_t> frequency = FrequencyIndex::ParseTuning(tuning);
+    if (!frequency)
+    {
+        return std::vector<TunedFacility>();
+    }
+    return _frequencies.query(*frequency, position, range);
+}
+
+// ----------------------------------------------------------------------------
+
+const FrequencyIndex &AirportFileManager::getFrequencyIndex() const
+{
+    return _frequencies;
+}
+
+// ----------------------------------------------------------------------------
+
+const ILSSystemTable &AirportFileManager::getILSSystemTable() const
+{
+    return _ilsSystems;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<ILSDeviation> AirportFileManager::getILSDeviations(const std::vector<Data::LatitudeLongitude> &positions, const std::vector<double> &altitudes, size_t threads) const
+{
+    return _ilsBeams.computeDeviations(positions, altitudes, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+const ILSBeamTable &AirportFileManager::getILSBeamTable() const
+{
+    return _ilsBeams;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<FuzzyAirportMatch> AirportFileManager::findAirportsFuzzy(const std::string &text, size_t maxDistance, size_t limit) const
+{
+    // identifier matches come first so they win ties against names
+    std::vector<FuzzyMatch> matches = _fuzzyIdentifiers.search(text, maxDistance, limit);
+    const std::vector<FuzzyMatch> names = _fuzzyNames.search(text, maxDistance, limit);
+    matches.insert(matches.end(), names.begin(), names.end());
+    std::stable_sort(matches.begin(), matches.end(), [](const FuzzyMatch &a, const FuzzyMatch &b)
+    {
+        return a.distance < b.distance;
+    });
+
+    std::vector<FuzzyAirportMatch> out;
+    std::unordered_set<size_t> seen;
+    for (const FuzzyMatch &match : matches)
+    {
+        if (limit != 0 && out.size() >= limit)
+        {
+            break;
+        }
+        if (seen.insert(match.row).second)
+        {
+            out.push_back({ _base.getAirportIdentifier(match.row), match.row, match.distance });
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+void AirportFileManager::buildRemarkIndexes(size_t threads)
+{
+    if (_remarks.isValid())
+    {
+        _airportRemarkIndex = std::make_shared<RemarkIndex>(_remarks.getColumn("REMARK").get(), threads);
+    }
+    if (_ilsRemarks.isValid())
+    {
+        _ilsRemarkIndex = std::make_shared<RemarkIndex>(_ilsRemarks.getColumn("REMARK").get(), threads);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool AirportFileManager::hasRemarkIndexes() const
+{
+    return _airportRemarkIndex != nullptr && _ilsRemarkIndex != nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RemarkSearchResult> AirportFileManager::searchRemarks(const std::string &query) const
+{
+    std::vector<RemarkSearchResult> out;
+    if (_airportRemarkIndex)
+    {
+        for (size_t row : _airportRemarkIndex->search(query))
+        {
+            const CSV::Row remark = _remarks.getRow(row);
+            out.push_back({ RemarkSource::AIRPORT, remark["ARPT_ID"], remark["REF_COL_NAME"], remark["ELEMENT"], remark["REMARK"], row });
+        }
+    }
+    if (_ilsRemarkIndex)
+    {
+        for (size_t row : _ilsRemarkIndex->search(query))
+        {
+            const CSV::Row remark = _ilsRemarks.getRow(row);
+            out.push_back({ RemarkSource::ILS, remark["ARPT_ID"], remark["REF_COL_NAME"], remark["ILS_LOC_ID"], remark["REMARK"], row });
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<AirportSearchResult> AirportFileManager::searchAirports(const std::string &text, TextMatch mode, size_t limit) const
+{
+    std::vector<AirportSearchResult> out;
+    for (const TextSearchResult &result : _airportNames.search(text, mode, limit))
     {
-        return getAirport(_base[indices[0]]["ARPT_ID"]);
+        out.push_back({ _base.getAirportIdentifier(result.row), result.row, result.score });
     }
-    return getAirport(identifier);
+    return out;
 }
 
 // ----------------------------------------------------------------------------
@@ -32,6 +32,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "csv.h"
+#include "airportGraph.h"
+#include "airportRowGroups.h"
+#include "airportRanking.h"
+#include "attendanceTable.h"
+#include "bloomFilter.h"
+#include "frequencyIndex.h"
+#include "fuzzyIndex.h"
+#include "hashJoin.h"
+#include "identifierIndex.h"
+#include "ilsBeamTable.h"
+#include "ilsSystemTable.h"
 #include "airportBaseEntry.h"
 #include "arrestingEntry.h"
 #include "attendanceEntry.h"
@@ -44,7 +55,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "dmeEntry.h"
 #include "markerEntry.h"
 #include "ilsRemarksEntry.h"
+#include "runwayHeadingTable.h"
+#include "runwayJoinTable.h"
+#include "runwayWindTable.h"
+#include "solarLightingTable.h"
+#include "parallel.h"
+#include "queryEngine.h"
+#include "remarkGroupTable.h"
+#include "remarkIndex.h"
+#include "spatialIndex.h"
+#include "trigramIndex.h"
 
+#include <functional>
 #include <memory>
 
 namespace NASR
@@ -76,28 +98,168 @@ public:
 
 // ----------------------------------------------------------------------------
 
+enum class FacilityType
+{
+    AIRPORT,
+    RUNWAY_END,
+    ILS,
+    MARKER
+};
+
+// ----------------------------------------------------------------------------
+
+struct FacilityEntry
+{
+    FacilityType type;
+    std::string airportIdentifier;  // ARPT_ID of the owning airport
+    std::string facilityIdentifier; // ARPT_ID, RWY_END_ID or ILS_LOC_ID depending on type
+    size_t rowIndex;                // row within the facility's source file
+    Data::LatitudeLongitude location;
+};
+
+// ----------------------------------------------------------------------------
+
+struct RouteCorridorEntry
+{
+    FacilityEntry facility;
+    double alongTrackDistance;      // nautical miles from the first waypoint
+    double crossTrackDistance;      // nautical miles, positive to the right of the route
+};
+
+// ----------------------------------------------------------------------------
+
+struct FacilityPair
+{
+    FacilityEntry first;
+    FacilityEntry second;
+    double distance;                // nautical miles
+};
+
+// ----------------------------------------------------------------------------
+
+struct AirportSearchResult
+{
+    std::string identifier;         // ARPT_ID
+    size_t rowIndex;                // row within APT_BASE
+    double score;                   // higher is a better match
+};
+
+// ----------------------------------------------------------------------------
+
+struct RankedAirport
+{
+    std::string identifier;         // ARPT_ID
+    size_t rowIndex;                // row within APT_BASE
+    double value;                   // the ranked AirportMetric
+};
+
+// ----------------------------------------------------------------------------
+
+// the components of one ILS system together with the runway end it serves
+struct ILSApproach
+{
+    ILS::BaseEntry localizer;
+    tl::optional<APT::RunwayEndEntry> runwayEnd;
+    tl::optional<ILS::GlideslopeEntry> glideslope;
+    tl::optional<ILS::DMEEntry> dme;
+    std::vector<ILS::MarkerEntry> markers;
+    std::vector<ILS::RemarksEntry> remarks;
+};
+
+// ----------------------------------------------------------------------------
+
+struct FuzzyAirportMatch
+{
+    std::string identifier;         // ARPT_ID
+    size_t rowIndex;                // row within APT_BASE
+    size_t distance;                // edit distance to the closest identifier or name
+};
+
+// ----------------------------------------------------------------------------
+
+enum class RemarkSource
+{
+    AIRPORT,
+    ILS
+};
+
+// ----------------------------------------------------------------------------
+
+struct RemarkSearchResult
+{
+    RemarkSource source;
+    std::string airportIdentifier;  // ARPT_ID
+    std::string referenceColumn;    // REF_COL_NAME
+    std::string element;            // ELEMENT for airport remarks, ILS_LOC_ID for ILS remarks
+    std::string remark;
+    size_t rowIndex;                // row within APT_RMK or ILS_RMK
+};
+
+// ----------------------------------------------------------------------------
+
 class AirportFile : public CSV::File
 {
 public:
     AirportFile();
-    AirportFile(const std::string& filename);
+    AirportFile(const std::string& filename, const std::vector<std::vector<std::string>>& indexes = std::vector<std::vector<std::string>>());
     std::vector<std::string> getAirportIdentifiers() const;
+    const std::string& getAirportIdentifier(size_t rowIndex) const;
     std::vector<size_t> getAirportRowIndices(const std::string& locationIdentifier) const;
     const CSV::Column& getCachedColumn(const std::string& name);
+    const CSV::Column& getCachedColumn(const std::string& name) const; // only returns columns that are already cached
+    std::vector<Data::LatitudeLongitude> getLocations(const std::string& latitudeColumn = "LAT_DECIMAL", const std::string& longitudeColumn = "LONG_DECIMAL") const;
 private:
     std::unordered_map<std::string, CSV::Column> _cachedColumns;
 };
 
 // ----------------------------------------------------------------------------
 
+class AirportFileManager;
+
+// ----------------------------------------------------------------------------
+
+// One airport as handed out by AirportFileManager::forEachAirport: its APT_BASE
+// row and the rows it owns in every file, grouped at load time, so nothing is
+// looked up by identifier.  Entries are only built when asked for.
+class AirportView
+{
+public:
+    AirportView(const AirportFileManager& manager, size_t baseRow);
+
+    size_t getRowIndex() const;                 // APT_BASE row
+    const std::string& getIdentifier() const;   // ARPT_ID
+    const CSV::File& getFile(SourceFile file) const;
+    CSV::RowSpan getRows(SourceFile file) const;
+
+    template <typename T>
+    std::vector<T> getEntries(SourceFile file) const
+    {
+        std::vector<T> out;
+        const CSV::File& source = getFile(file);
+        for (uint32_t row : getRows(file))
+        {
+            out.emplace_back(T(source.getRow(row)));
+        }
+        return out;
+    }
+
+    IAirport::Ptr getAirport() const;
+
+private:
+    const AirportFileManager* _manager;
+    size_t _row;
+};
+
+// ----------------------------------------------------------------------------
+
 class AirportFileManager
 {
 public:
     AirportFileManager();
-    AirportFileManager(const std::string& directory);
+    AirportFileManager(const std::string& directory, bool indexRemarks = false);
 
     bool isInitialized() const;
-    void loadFrom(const std::string& csvDirectory);
+    void loadFrom(const std::string& csvDirectory, bool indexRemarks = false);
     const std::string& getLastLoadedDirectory() const;
 
     std::vector<std::string> getAirportIdentifiers() const;
@@ -105,7 +267,124 @@ public:
     IAirport::Ptr getAirport(const std::string& identifier) const;
     IAirport::Ptr getAirportByICAO(const std::string& identifier);
 
+    // calls callback for every airport, in APT_BASE order within each chunk of airports and
+    // concurrently across chunks; chunks are claimed by parallelism threads (zero for one per
+    // hardware thread) or handed as tasks to the executor
+    void forEachAirport(const std::function<void(const AirportView&)>& callback, size_t parallelism = 0) const;
+    void forEachAirport(const std::function<void(const AirportView&)>& callback, const Parallel::Executor& executor, size_t chunkSize = 256) const;
+
+    // counters of the Bloom filter over ARPT_ID and ICAO_ID that screens the two lookups above
+    BloomFilterStatistics getIdentifierFilterStatistics() const;
+
+    // sorted ARPT_ID and ICAO_ID values of APT_BASE for exact, prefix and range lookups
+    const IdentifierIndex& getAirportIdentifierIndex() const;
+    const IdentifierIndex& getICAOIdentifierIndex() const;
+
+    // ILS systems serving a runway end, e.g. getILSApproaches("SFO", "28R"), and the
+    // row-level join they are assembled from
+    std::vector<ILSApproach> getILSApproaches(const std::string& airportIdentifier, const std::string& runwayEnd) const;
+    const ILSSystemTable& getILSSystemTable() const;
+
+    // localizer and glideslope deviations of many aircraft from every ILS in range (see ILSBeamTable)
+    std::vector<ILSDeviation> getILSDeviations(const std::vector<Data::LatitudeLongitude>& positions, const std::vector<double>& altitudes, size_t threads = 0) const;
+    const ILSBeamTable& getILSBeamTable() const;
+
+    // APT_RMK rows of an airport's table, optionally narrowed to one ELEMENT, in REF_COL_NAME
+    // and REF_COL_SEQ_NO order, e.g. getRemarks("SFO", APT::RemarksTable::RUNWAY_END, "10L/28R/28R")
+    std::vector<APT::RemarksEntry> getRemarks(const std::string& airportIdentifier, APT::RemarksTable table) const;
+    std::vector<APT::RemarksEntry> getRemarks(const std::string& airportIdentifier, APT::RemarksTable table, const std::string& element) const;
+    const RemarkGroupTable& getRemarkGroupTable() const;
+
+    // localizers, glideslopes, DMEs and markers tuned by "110.30", "40X" or "338" (kHz) within range nautical
+    // miles of the position, nearest first; glideslopes and DMEs are also found by their localizer's frequency
+    std::vector<TunedFacility> getTunedFacilities(const std::string& tuning, const Data::LatitudeLongitude& position, double range) const;
+    const FrequencyIndex& getFrequencyIndex() const;
+
+    // airports whose ARPT_ID, ICAO_ID or name lies within maxDistance edits of the text, nearest first
+    std::vector<FuzzyAirportMatch> findAirportsFuzzy(const std::string& text, size_t maxDistance = 2, size_t limit = 10) const;
+
+    // airports (and optionally ILS localizers) within halfWidth nautical miles of the
+    // great-circle route through the waypoints, sorted by along-track distance
+    std::vector<RouteCorridorEntry> getFacilitiesAlongRoute(const std::vector<Data::LatitudeLongitude>& route, double halfWidth, bool includeILS = false) const;
+
+    // airports, runway ends and marker beacons inside the polygon (see Geo::Polygon)
+    std::vector<FacilityEntry> getFacilitiesInPolygon(const std::vector<Data::LatitudeLongitude>& polygon) const;
+    std::vector<FacilityEntry> getFacilitiesInPolygon(const Geo::Polygon& polygon, const std::vector<FacilityType>& types) const;
+
+    // pairs of facilities of one type within distance nautical miles of each other, optionally
+    // restricted to pairs with equal, non-empty values in keyColumn of the facility's file
+    std::vector<FacilityPair> getFacilityPairsWithin(FacilityType type, double distance, const std::string& keyColumn = "", size_t threads = 0) const;
+    std::vector<FacilityPair> getILSFrequencyConflicts(double distance = 50.0, size_t threads = 0) const;
+
+    // proximity graph connecting airports within range nautical miles that meet the runway criteria
+    AirportGraph buildAirportGraph(double range, const RunwayCriteria& criteria = RunwayCriteria(), size_t threads = 0) const;
+
+    // airports, in APT_BASE order, whose numeric column lies within [minimum, maximum]; the column is one of
+    // ELEV and BASED_* from APT_BASE or RWY_LEN from APT_RWY, matching when any runway qualifies
+    std::vector<std::string> getAirportIdentifiersInRange(const std::string& column, double minimum, double maximum) const;
+
+    // rows of a file, or airports, matching a predicate over its columns (see Predicate)
+    std::vector<size_t> selectRows(SourceFile file, const Predicate& predicate, size_t threads = 0) const;
+    std::vector<IAirport::Ptr> selectAirports(const Predicate& predicate, size_t threads = 0) const;
+
+    // row pairs of two files with equal values in the key columns (see HashJoin), e.g.
+    // joinFiles(SourceFile::APT_RWY_END, RunwayJoinTable::RUNWAY_END_KEY, SourceFile::APT_ARS, RunwayJoinTable::RUNWAY_END_KEY);
+    // the view refers to this manager's files and is invalidated by the next load
+    JoinedView joinFiles(SourceFile left, const std::vector<std::string>& leftColumns, SourceFile right, const std::vector<std::string>& rightColumns, size_t threads = 0) const;
+
+    // counts, sums, minimums, maximums and averages per group of rows, e.g. operations by region:
+    // aggregate(SourceFile::APT_BASE, { "REGION_CODE" }, { { AggregateFunction::SUM, { "COMMERCIAL_OPS", "LOCAL_OPS" } } })
+    std::vector<AggregateGroup> aggregate(SourceFile file, const std::vector<std::string>& groupBy, const std::vector<Aggregation>& aggregations, size_t threads = 0) const;
+    std::vector<AggregateGroup> aggregate(SourceFile file, const Predicate& predicate, const std::vector<std::string>& groupBy, const std::vector<Aggregation>& aggregations, size_t threads = 0) const;
+
+    // the k airports with the highest metric, anywhere, inside a box or within radius nautical miles
+    // of a position; rankings without a filter are cached until the next load
+    std::vector<RankedAirport> getTopAirports(AirportMetric metric, size_t k) const;
+    std::vector<RankedAirport> getTopAirports(AirportMetric metric, size_t k, const Geo::BoundingBox& box) const;
+    std::vector<RankedAirport> getTopAirports(AirportMetric metric, size_t k, const Data::LatitudeLongitude& center, double radius) const;
+    const AirportRanking& getAirportRanking() const;
+
+    // whether an airport is attended at a time local to it, from its compiled APT_ATT schedules
+    bool isAttendedAt(const std::string& airportIdentifier, const std::tm& localTime) const;
+    const AttendanceTable& getAttendanceTable() const;
+
+    // runway and beacon lights on a sunset-to-sunrise schedule that are on at the UTC time, for
+    // every airport in APT_BASE order (see SolarLightingTable); sun times are cached per day
+    void computeAirportLighting(std::time_t utc, std::vector<uint8_t>& out) const;
+    const SolarLightingTable& getSolarLightingTable() const;
+
+    // every runway end joined with its runway, airport and arresting gear, in airport order
+    const RunwayJoinTable& getRunwayJoinTable() const;
+
+    // true and magnetic heading and ILS approach bearing of every runway end by RunwayJoinTable ID,
+    // and the magnetic variation of every airport
+    const RunwayHeadingTable& getRunwayHeadingTable() const;
+
+    // packed runway end headings and lengths for batch wind component and runway selection
+    const RunwayWindTable& getRunwayWindTable() const;
+
+    // case-insensitive search over airport name, city and county, best matches first
+    std::vector<AirportSearchResult> searchAirports(const std::string& text, TextMatch mode = TextMatch::SUBSTRING, size_t limit = 20) const;
+
+    // remark search over APT_RMK and ILS_RMK (see RemarkIndex for the query syntax); the
+    // indexes are only built when requested at load time or through buildRemarkIndexes
+    void buildRemarkIndexes(size_t threads = 0);
+    bool hasRemarkIndexes() const;
+    std::vector<RemarkSearchResult> searchRemarks(const std::string& query) const;
+
 private:
+    friend class AirportView;
+
+    void buildSpatialIndexes();
+    void buildFrequencyIndex();
+    IAirport::Ptr makeAirport(size_t baseRow) const;
+    bool isFilterMember(const std::string& identifier) const;
+    std::vector<RankedAirport> makeRankedAirports(const std::vector<RankedRow>& rows) const;
+    const AirportFile& getSourceFile(SourceFile file) const;
+    std::vector<const CSV::File*> getSourceFiles() const;
+    const AirportFile& getFacilityFile(FacilityType type) const;
+    const SpatialIndex& getSpatialIndex(FacilityType type) const;
+    FacilityEntry makeFacilityEntry(FacilityType type, size_t rowIndex) const;
 
     template <typename T>
     std::vector<T> getEntriesForAirport(const AirportFile& source, const std::string& locationIdentifier) const
@@ -137,6 +416,42 @@ private:
     AirportFile _dme;
     AirportFile _marker;
     AirportFile _ilsRemarks;
+
+    // rows of every file grouped by APT_BASE row, indexed by SourceFile
+    AirportRowGroups _airportRows;
+
+    // spatial indexes over the packed coordinates of each file
+    SpatialIndex _airportLocations;
+    SpatialIndex _runwayEndLocations;
+    SpatialIndex _ilsLocations;
+    SpatialIndex _markerLocations;
+
+    RunwayWindTable _runwayWindTable;
+    RunwayJoinTable _runwayJoin;
+    RunwayHeadingTable _runwayHeadings;
+    ILSSystemTable _ilsSystems;
+    ILSBeamTable _ilsBeams;
+    FrequencyIndex _frequencies;
+    RemarkGroupTable _remarkGroups;
+    AirportRanking _ranking;
+    AttendanceTable _attendanceTable;
+    SolarLightingTable _solarLighting;
+
+    IdentifierIndex _airportIdentifiers;
+    IdentifierIndex _icaoIdentifiers;
+    BloomFilter _identifierFilter;  // ARPT_ID and ICAO_ID
+    FuzzyIndex _fuzzyIdentifiers;   // ARPT_ID and ICAO_ID
+    FuzzyIndex _fuzzyNames;         // ARPT_NAME
+
+    // trigram index over ARPT_NAME, CITY and COUNTY_NAME
+    TrigramIndex _airportNames;
+
+    // decoded columns for selectRows and selectAirports, filled on first use
+    QueryEngine _query;
+
+    // optional, see buildRemarkIndexes
+    std::shared_ptr<const RemarkIndex> _airportRemarkIndex;
+    std::shared_ptr<const RemarkIndex> _ilsRemarkIndex;
 };
 
 // ----------------------------------------------------------------------------
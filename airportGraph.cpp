@@ -0,0 +1,259 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "airportGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+AirportGraph::AirportGraph()
+    : _range(0.0), _offsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+AirportGraph::AirportGraph(const SpatialIndex &locations, const std::vector<std::string> &identifiers, const std::vector<bool> &eligible, double range, size_t threads)
+    : _range(range), _identifiers(identifiers)
+{
+    const size_t nodeCount = locations.size();
+    _locations.reserve(nodeCount);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        _locations.push_back(locations.getPoint(node));
+        _lookup.emplace(_identifiers[node], node);
+    }
+
+    const std::vector<SpatialPair> pairs = locations.selfJoinWhere(range, [&eligible](size_t first, size_t second)
+    {
+        return eligible[first] && eligible[second];
+    }, threads);
+
+    // each pair becomes an edge in both directions
+    _offsets.assign(nodeCount + 1, 0);
+    for (const SpatialPair &pair : pairs)
+    {
+        _offsets[pair.first + 1]++;
+        _offsets[pair.second + 1]++;
+    }
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        _offsets[node + 1] += _offsets[node];
+    }
+
+    _targets.resize(_offsets.back());
+    _weights.resize(_offsets.back());
+    std::vector<uint32_t> cursor(_offsets.begin(), _offsets.end() - 1);
+    for (const SpatialPair &pair : pairs)
+    {
+        const uint32_t forward = cursor[pair.first]++;
+        _targets[forward] = static_cast<uint32_t>(pair.second);
+        _weights[forward] = static_cast<float>(pair.distance);
+
+        const uint32_t backward = cursor[pair.second]++;
+        _targets[backward] = static_cast<uint32_t>(pair.first);
+        _weights[backward] = static_cast<float>(pair.distance);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+double AirportGraph::getRange() const
+{
+    return _range;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AirportGraph::getNodeCount() const
+{
+    return _offsets.size() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AirportGraph::getEdgeCount() const
+{
+    return _targets.size();
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &AirportGraph::getOffsets() const
+{
+    return _offsets;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &AirportGraph::getTargets() const
+{
+    return _targets;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &AirportGraph::getWeights() const
+{
+    return _weights;
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<size_t> AirportGraph::getNode(const std::string &identifier) const
+{
+    std::unordered_map<std::string, size_t>::const_iterator search = _lookup.find(identifier);
+    if (search != _lookup.end())
+    {
+        return search->second;
+    }
+    return tl::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::string &AirportGraph::getIdentifier(size_t node) const
+{
+    return _identifiers[node];
+}
+
+// ----------------------------------------------------------------------------
+
+GraphPath AirportGraph::findPath(size_t origin, size_t destination, PathMetric metric) const
+{
+    GraphPath out{ false, {}, 0.0, 0 };
+    const size_t nodeCount = getNodeCount();
+    if (origin >= nodeCount || destination >= nodeCount || !_locations[origin].valid() || !_locations[destination].valid())
+    {
+        return out;
+    }
+
+    // costs are compared lexicographically: (metric being minimized, the other one)
+    typedef std::pair<double, double> Cost;
+    struct QueueItem
+    {
+        Cost priority;
+        Cost cost;
+        uint32_t node;
+        bool operator>(const QueueItem &other) const { return priority > other.priority; }
+    };
+
+    const Data::LatitudeLongitude &goal = _locations[destination];
+    const auto heuristic = [&](size_t node)
+    {
+        const double remaining = Geo::Distance(_locations[node], goal);
+        if (metric == PathMetric::HOPS)
+        {
+            // every leg covers at most the graph's range
+            return _range > 0.0 ? std::ceil(remaining / _range - 1e-9) : 0.0;
+        }
+        return remaining;
+    };
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<Cost> best(nodeCount, Cost(infinity, infinity));
+    std::vector<uint32_t> previous(nodeCount, std::numeric_limits<uint32_t>::max());
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> open;
+
+    best[origin] = Cost(0.0, 0.0);
+    open.push({ Cost(heuristic(origin), 0.0), best[origin], static_cast<uint32_t>(origin) });
+    while (!open.empty())
+    {
+        const QueueItem item = open.top();
+        open.pop();
+
+        if (item.cost != best[item.node])
+        {
+            // superseded by a cheaper route to the same node
+            continue;
+        }
+        if (item.node == destination)
+        {
+            break;
+        }
+
+        for (uint32_t edge = _offsets[item.node]; edge < _offsets[item.node + 1]; edge++)
+        {
+            const uint32_t target = _targets[edge];
+            const double distance = _weights[edge];
+            const Cost candidate = metric == PathMetric::HOPS ? Cost(item.cost.first + 1.0, item.cost.second + distance) : Cost(item.cost.first + distance, item.cost.second + 1.0);
+            if (candidate < best[target])
+            {
+                best[target] = candidate;
+                previous[target] = item.node;
+                open.push({ Cost(candidate.first + heuristic(target), candidate.second), candidate, target });
+            }
+        }
+    }
+
+    if (best[destination].first == infinity)
+    {
+        return out;
+    }
+
+    for (size_t node = destination; node != origin; node = previous[node])
+    {
+        out.nodes.push_back(node);
+    }
+    out.nodes.push_back(origin);
+    std::reverse(out.nodes.begin(), out.nodes.end());
+
+    out.found = true;
+    out.hops = out.nodes.size() - 1;
+    out.distance = metric == PathMetric::HOPS ? best[destination].second : best[destination].first;
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+GraphPath AirportGraph::findPath(const std::string &origin, const std::string &destination, PathMetric metric) const
+{
+    const tl::optional<size_t> from = getNode(origin);
+    const tl::optional<size_t> to = getNode(destination);
+    if (!from || !to)
+    {
+        return GraphPath{ false, {}, 0.0, 0 };
+    }
+    return findPath(*from, *to, metric);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,113 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "spatialIndex.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+enum class PathMetric
+{
+    DISTANCE,
+    HOPS
+};
+
+// ----------------------------------------------------------------------------
+
+// an airport qualifies when at least one of its runways satisfies every criterion
+struct RunwayCriteria
+{
+    RunwayCriteria(int minimumLength = 0, bool pavedOnly = false) : minimumLength(minimumLength), pavedOnly(pavedOnly) {}
+
+    int minimumLength; // feet
+    bool pavedOnly;
+};
+
+// ----------------------------------------------------------------------------
+
+struct GraphPath
+{
+    bool found;
+    std::vector<size_t> nodes;  // APT_BASE row indices from origin to destination
+    double distance;            // nautical miles
+    size_t hops;
+};
+
+// ----------------------------------------------------------------------------
+
+// Proximity graph over the airports of a cycle, stored in compressed sparse
+// row form: the neighbours of node n are targets[offsets[n] .. offsets[n + 1]).
+// Nodes are APT_BASE row indices; airports that did not meet the criteria the
+// graph was built with have no edges.
+class AirportGraph
+{
+public:
+    AirportGraph();
+    AirportGraph(const SpatialIndex& locations, const std::vector<std::string>& identifiers, const std::vector<bool>& eligible, double range, size_t threads = 0);
+
+    double getRange() const;
+    size_t getNodeCount() const;
+    size_t getEdgeCount() const;
+    const std::vector<uint32_t>& getOffsets() const;
+    const std::vector<uint32_t>& getTargets() const;
+    const std::vector<float>& getWeights() const;
+
+    tl::optional<size_t> getNode(const std::string& identifier) const;
+    const std::string& getIdentifier(size_t node) const;
+
+    // A* search using great-circle distance to the destination as the heuristic;
+    // HOPS minimizes the number of legs and breaks ties on distance
+    GraphPath findPath(size_t origin, size_t destination, PathMetric metric = PathMetric::DISTANCE) const;
+    GraphPath findPath(const std::string& origin, const std::string& destination, PathMetric metric = PathMetric::DISTANCE) const;
+
+private:
+    double _range;
+    std::vector<Data::LatitudeLongitude> _locations;
+    std::vector<std::string> _identifiers;
+    std::unordered_map<std::string, size_t> _lookup;
+
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _targets;
+    std::vector<float> _weights;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,213 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "airportRanking.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+// sum of the non-empty values of the columns per row, NaN when all are empty;
+// columns missing from the file are skipped
+std::vector<float> SumColumns(const CSV::File &file, const std::vector<std::string> &columns)
+{
+    std::vector<float> out;
+    for (const std::string &name : columns)
+    {
+        std::vector<std::string> values;
+        try
+        {
+            values = file.getColumn(name).get();
+        }
+        catch (const std::out_of_range &)
+        {
+            continue;
+        }
+        out.resize(values.size(), std::numeric_limits<float>::quiet_NaN());
+        for (size_t row = 0; row < values.size(); row++)
+        {
+            const std::string &value = values[row];
+            const tl::optional<double> parsed = value.empty() ? tl::nullopt : CSV::Utils::ParseOptional<double>(value);
+            if (parsed)
+            {
+                out[row] = std::isnan(out[row]) ? static_cast<float>(*parsed) : out[row] + static_cast<float>(*parsed);
+            }
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+// visits rows [0, count) for AirportRanking::topOf
+struct EveryRow
+{
+    size_t count;
+
+    template <typename TCallback>
+    void operator()(TCallback callback) const
+    {
+        for (size_t row = 0; row < count; row++)
+        {
+            callback(row);
+        }
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+// visits the rows of a list for AirportRanking::topOf
+struct ListedRows
+{
+    const std::vector<size_t> &rows;
+
+    template <typename TCallback>
+    void operator()(TCallback callback) const
+    {
+        for (size_t row : rows)
+        {
+            callback(row);
+        }
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+AirportRanking::AirportRanking()
+    : _cache(std::make_shared<Cache>())
+{
+}
+
+// ----------------------------------------------------------------------------
+
+AirportRanking::AirportRanking(const CSV::File &base, const CSV::File &runways)
+    : _cache(std::make_shared<Cache>())
+{
+    if (!base.isValid())
+    {
+        return;
+    }
+
+    _values[static_cast<size_t>(AirportMetric::TOTAL_OPERATIONS)] = Detail::SumColumns(base, { "COMMERCIAL_OPS", "COMMUTER_OPS", "AIR_TAXI_OPS", "LOCAL_OPS", "ITNRNT_OPS", "MIL_ACFT_OPS" });
+    _values[static_cast<size_t>(AirportMetric::BASED_AIRCRAFT)] = Detail::SumColumns(base, { "BASED_SINGLE_ENG", "BASED_MULTI_ENG", "BASED_JET_ENG", "BASED_HEL", "BASED_GLIDERS", "BASED_MIL_ACFT", "BASED_ULTRALGT_ACFT" });
+
+    const std::vector<std::string> airportIdentifiers = base.getColumn("ARPT_ID").get();
+    std::vector<float> &longest = _values[static_cast<size_t>(AirportMetric::LONGEST_RUNWAY)];
+    longest.assign(airportIdentifiers.size(), std::numeric_limits<float>::quiet_NaN());
+    if (!runways.isValid())
+    {
+        return;
+    }
+
+    std::unordered_map<std::string, size_t> airportRows;
+    airportRows.reserve(airportIdentifiers.size());
+    for (size_t row = 0; row < airportIdentifiers.size(); row++)
+    {
+        airportRows.emplace(airportIdentifiers[row], row);
+    }
+
+    const CSV::Column runwayAirports = runways.getColumn("ARPT_ID");
+    const std::vector<float> lengths = Detail::SumColumns(runways, { "RWY_LEN" });
+    for (size_t row = 0; row < lengths.size(); row++)
+    {
+        std::unordered_map<std::string, size_t>::const_iterator airport = airportRows.find(runwayAirports.get()[row]);
+        if (airport != airportRows.end() && !std::isnan(lengths[row]))
+        {
+            float &value = longest[airport->second];
+            value = std::isnan(value) ? lengths[row] : std::max(value, lengths[row]);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AirportRanking::size() const
+{
+    return _values[0].size();
+}
+
+// ----------------------------------------------------------------------------
+
+float AirportRanking::getValue(AirportMetric metric, size_t row) const
+{
+    return _values[static_cast<size_t>(metric)][row];
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &AirportRanking::getValues(AirportMetric metric) const
+{
+    return _values[static_cast<size_t>(metric)];
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RankedRow> AirportRanking::top(AirportMetric metric, size_t k) const
+{
+    // no ranking of every airport holds more than size() rows, so larger requests share its cache
+    k = std::min(k, size());
+    const size_t index = static_cast<size_t>(metric);
+    std::lock_guard<std::mutex> lock(_cache->mutex);
+    if (_cache->requested[index] < k)
+    {
+        _cache->rankings[index] = topOf(metric, k, Detail::EveryRow{ size() });
+        _cache->requested[index] = k;
+    }
+
+    const std::vector<RankedRow> &ranking = _cache->rankings[index];
+    return std::vector<RankedRow>(ranking.begin(), ranking.begin() + std::min(k, ranking.size()));
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RankedRow> AirportRanking::top(AirportMetric metric, size_t k, const std::vector<size_t> &rows) const
+{
+    return topOf(metric, k, Detail::ListedRows{ rows });
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,137 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+enum class AirportMetric
+{
+    TOTAL_OPERATIONS,   // sum of the *_OPS columns
+    BASED_AIRCRAFT,     // sum of the BASED_* columns
+    LONGEST_RUNWAY      // largest RWY_LEN, feet
+};
+
+constexpr size_t AIRPORT_METRIC_COUNT = 3;
+
+// ----------------------------------------------------------------------------
+
+struct RankedRow
+{
+    size_t row;         // APT_BASE row index
+    float value;
+};
+
+// ----------------------------------------------------------------------------
+
+// Per-airport metrics packed in APT_BASE row order for level-of-detail
+// ranking.  top() keeps a k-element min-heap while scanning, so a ranking
+// costs one pass plus k log k to order the survivors; rows without a value
+// are never ranked and ties go to the lower row.  Rankings of every airport
+// are cached, and a cached ranking also answers any smaller k; copies of a
+// table share that cache.
+class AirportRanking
+{
+public:
+    AirportRanking();
+    AirportRanking(const CSV::File& base, const CSV::File& runways);
+
+    size_t size() const;
+    float getValue(AirportMetric metric, size_t row) const;        // NaN when unknown
+    const std::vector<float>& getValues(AirportMetric metric) const;
+
+    std::vector<RankedRow> top(AirportMetric metric, size_t k) const;
+    std::vector<RankedRow> top(AirportMetric metric, size_t k, const std::vector<size_t>& rows) const;
+
+    // the k highest of the rows passed to callback by forEachRow(callback), e.g. those of a spatial query
+    template <typename TForEachRow>
+    std::vector<RankedRow> topOf(AirportMetric metric, size_t k, TForEachRow forEachRow) const
+    {
+        const std::vector<float>& values = getValues(metric);
+        std::vector<RankedRow> heap;
+        heap.reserve(std::min(k, values.size()));
+        forEachRow([&](size_t row)
+        {
+            const float value = values[row];
+            if (k == 0 || std::isnan(value))
+            {
+                return;
+            }
+            if (heap.size() < k)
+            {
+                heap.push_back({ row, value });
+                std::push_heap(heap.begin(), heap.end(), Better);
+            }
+            else if (Better({ row, value }, heap.front()))
+            {
+                std::pop_heap(heap.begin(), heap.end(), Better);
+                heap.back() = { row, value };
+                std::push_heap(heap.begin(), heap.end(), Better);
+            }
+        });
+        std::sort_heap(heap.begin(), heap.end(), Better);
+        return heap;
+    }
+
+private:
+    // orders by descending value then ascending row, making the heap front the worst kept row
+    static bool Better(const RankedRow& a, const RankedRow& b)
+    {
+        return a.value > b.value || (a.value == b.value && a.row < b.row);
+    }
+
+    struct Cache
+    {
+        std::mutex mutex;
+        std::vector<RankedRow> rankings[AIRPORT_METRIC_COUNT];
+        size_t requested[AIRPORT_METRIC_COUNT] = {};
+    };
+
+private:
+    std::vector<float> _values[AIRPORT_METRIC_COUNT];
+    std::shared_ptr<Cache> _cache;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
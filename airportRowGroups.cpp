@@ -0,0 +1,120 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "airportRowGroups.h"
+#include "parallel.h"
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+AirportRowGroups::AirportRowGroups()
+    : _airportCount(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+AirportRowGroups::AirportRowGroups(const CSV::File &base, const std::vector<const CSV::File *> &files, size_t threads)
+    : _airportCount(base.isValid() ? base.getColumn("ARPT_ID").get().size() : 0),
+      _files(files.size())
+{
+    // files are independent, so each is grouped on its own thread
+    Parallel::For(files.size(), threads, [&](size_t begin, size_t end, size_t)
+    {
+        for (size_t file = begin; file < end; file++)
+        {
+            Groups &groups = _files[file];
+            groups.offsets.assign(_airportCount + 1, 0);
+            if (!base.isValid() || !files[file]->isValid())
+            {
+                continue;
+            }
+
+            const CSV::Column airports = files[file]->getColumn("ARPT_ID");
+            std::vector<uint32_t> owners(airports.get().size(), 0xFFFFFFFF);
+            for (size_t row = 0; row < owners.size(); row++)
+            {
+                const CSV::RowSpan match = base.lookup("ARPT_ID", airports.get()[row]);
+                if (!match.empty())
+                {
+                    owners[row] = match[0];
+                    groups.offsets[match[0] + 1]++;
+                }
+            }
+            for (size_t airport = 0; airport < _airportCount; airport++)
+            {
+                groups.offsets[airport + 1] += groups.offsets[airport];
+            }
+
+            std::vector<uint32_t> cursor(groups.offsets.begin(), groups.offsets.end() - 1);
+            groups.rows.resize(groups.offsets.back());
+            for (size_t row = 0; row < owners.size(); row++)
+            {
+                if (owners[row] != 0xFFFFFFFF)
+                {
+                    groups.rows[cursor[owners[row]]++] = static_cast<uint32_t>(row);
+                }
+            }
+        }
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AirportRowGroups::getAirportCount() const
+{
+    return _airportCount;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AirportRowGroups::getFileCount() const
+{
+    return _files.size();
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan AirportRowGroups::getRows(size_t file, size_t baseRow) const
+{
+    const Groups &groups = _files[file];
+    if (baseRow + 1 >= groups.offsets.size())
+    {
+        return CSV::RowSpan();
+    }
+    return CSV::RowSpan(groups.rows.data() + groups.offsets[baseRow], groups.rows.data() + groups.offsets[baseRow + 1]);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
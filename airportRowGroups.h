@@ -0,0 +1,75 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// Rows of several files grouped by the APT_BASE row of their ARPT_ID, so the
+// rows an airport owns in any file are one contiguous RowSpan addressed by
+// position alone.  Each file's groups are built with one pass over its
+// ARPT_ID column and a counting sort, keeping rows in file order; rows whose
+// airport is not in APT_BASE are left out.  APT_BASE needs an ARPT_ID index.
+class AirportRowGroups
+{
+public:
+    AirportRowGroups();
+    AirportRowGroups(const CSV::File& base, const std::vector<const CSV::File*>& files, size_t threads = 0);
+
+    size_t getAirportCount() const;
+    size_t getFileCount() const;
+
+    // rows of files[file] belonging to the airport in APT_BASE row baseRow
+    CSV::RowSpan getRows(size_t file, size_t baseRow) const;
+
+private:
+    struct Groups
+    {
+        std::vector<uint32_t> offsets;  // airports + 1 entries into rows
+        std::vector<uint32_t> rows;
+    };
+
+private:
+    size_t _airportCount;
+    std::vector<Groups> _files;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,475 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "attendanceTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr size_t AttendanceTable::MINUTES_PER_DAY;
+constexpr size_t AttendanceTable::MINUTES_PER_WEEK;
+constexpr size_t AttendanceTable::WORDS_PER_WEEK;
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+const char *const AttendanceMonths[] = { "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC" };
+const char *const AttendanceDays[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT" }; // std::tm::tm_wday order
+
+const uint32_t NO_WEEK = 0xFFFFFFFF;
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::string> SplitAttendanceList(const std::string &field)
+{
+    std::vector<std::string> out;
+    std::string token;
+    for (char c : field)
+    {
+        if (c == ',')
+        {
+            out.push_back(token);
+            token.clear();
+        }
+        else if (!std::isspace(static_cast<unsigned char>(c)))
+        {
+            token += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    out.push_back(token);
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+int FindAttendanceName(const std::string &token, const char *const *names, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (token == names[i])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+
+// bit i set for every names[i] the field selects, e.g. "APR-OCT" or "FRI-MON,WED"
+tl::optional<uint32_t> ParseAttendanceNames(const std::string &field, const char *const *names, int count)
+{
+    uint32_t mask = 0;
+    for (const std::string &token : SplitAttendanceList(field))
+    {
+        if (token == "ALL")
+        {
+            mask |= (1u << count) - 1;
+            continue;
+        }
+
+        const size_t dash = token.find('-');
+        const int first = FindAttendanceName(token.substr(0, dash), names, count);
+        const int last = dash == std::string::npos ? first : FindAttendanceName(token.substr(dash + 1), names, count);
+        if (first < 0 || last < 0)
+        {
+            return tl::nullopt;
+        }
+        for (int i = first;; i = (i + 1) % count)
+        {
+            mask |= 1u << i;
+            if (i == last)
+            {
+                break;
+            }
+        }
+    }
+    return mask;
+}
+
+// ----------------------------------------------------------------------------
+
+// minutes after midnight of "HHMM", up to "2400"
+tl::optional<size_t> ParseAttendanceClock(const std::string &text)
+{
+    if (text.size() != 4 || !std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }))
+    {
+        return tl::nullopt;
+    }
+
+    const size_t hours = static_cast<size_t>((text[0] - '0') * 10 + (text[1] - '0'));
+    const size_t minutes = static_cast<size_t>((text[2] - '0') * 10 + (text[3] - '0'));
+    if (minutes >= 60 || hours > 24 || (hours == 24 && minutes != 0))
+    {
+        return tl::nullopt;
+    }
+    return hours * 60 + minutes;
+}
+
+// ----------------------------------------------------------------------------
+
+void SetAttendanceMinutes(uint64_t *week, size_t start, size_t length)
+{
+    for (size_t minute = start; minute < start + length; minute++)
+    {
+        const size_t bit = minute % AttendanceTable::MINUTES_PER_WEEK;
+        week[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// the week of a DAY and HOUR pair, false when either could not be parsed
+bool CompileAttendanceWeek(const std::string &days, const std::string &hours, uint64_t *week)
+{
+    const tl::optional<uint32_t> dayMask = ParseAttendanceNames(days, AttendanceDays, 7);
+    if (!dayMask)
+    {
+        return false;
+    }
+
+    struct Window
+    {
+        size_t start;
+        size_t length;
+    };
+    std::vector<Window> windows;
+    for (const std::string &token : SplitAttendanceList(hours))
+    {
+        if (token == "ALL")
+        {
+            windows.push_back({ 0, AttendanceTable::MINUTES_PER_DAY });
+            continue;
+        }
+        if (token == "UNATNDD")
+        {
+            continue;
+        }
+
+        const size_t dash = token.find('-');
+        if (dash == std::string::npos)
+        {
+            return false;
+        }
+        const tl::optional<size_t> start = ParseAttendanceClock(token.substr(0, dash));
+        const tl::optional<size_t> end = ParseAttendanceClock(token.substr(dash + 1));
+        if (!start || !end || *start >= AttendanceTable::MINUTES_PER_DAY)
+        {
+            return false;
+        }
+        windows.push_back({ *start, *end > *start ? *end - *start : *end + AttendanceTable::MINUTES_PER_DAY - *start });
+    }
+
+    for (size_t day = 0; day < 7; day++)
+    {
+        if ((*dayMask & (1u << day)) == 0)
+        {
+            continue;
+        }
+        for (const Window &window : windows)
+        {
+            SetAttendanceMinutes(week, day * AttendanceTable::MINUTES_PER_DAY + window.start, window.length);
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool IsAttendanceTime(const std::tm &time)
+{
+    return time.tm_mon >= 0 && time.tm_mon < 12 &&
+           time.tm_wday >= 0 && time.tm_wday < 7 &&
+           time.tm_hour >= 0 && time.tm_hour < 24 &&
+           time.tm_min >= 0 && time.tm_min < 60;
+}
+
+// ----------------------------------------------------------------------------
+
+// index of the week with these bits, appending it to weeks when new
+uint32_t InternAttendanceWeek(const uint64_t *bits, std::vector<uint64_t> &weeks, std::unordered_map<std::string, uint32_t> &ids)
+{
+    const std::string key(reinterpret_cast<const char *>(bits), AttendanceTable::WORDS_PER_WEEK * sizeof(uint64_t));
+    std::unordered_map<std::string, uint32_t>::const_iterator found = ids.find(key);
+    if (found != ids.end())
+    {
+        return found->second;
+    }
+
+    const uint32_t id = static_cast<uint32_t>(weeks.size() / AttendanceTable::WORDS_PER_WEEK);
+    weeks.insert(weeks.end(), bits, bits + AttendanceTable::WORDS_PER_WEEK);
+    ids.emplace(key, id);
+    return id;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+AttendanceTable::AttendanceTable()
+    : _scheduleWeeks(12, 0),
+      _weeks(WORDS_PER_WEEK, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+AttendanceTable::AttendanceTable(const CSV::File &base, const CSV::File &attendance)
+    : _scheduleWeeks(12, 0),
+      _weeks(WORDS_PER_WEEK, 0)
+{
+    if (!base.isValid())
+    {
+        return;
+    }
+
+    const std::vector<std::string> airportIdentifiers = base.getColumn("ARPT_ID").get();
+    std::unordered_map<std::string, size_t> airportRows;
+    airportRows.reserve(airportIdentifiers.size());
+    for (size_t row = 0; row < airportIdentifiers.size(); row++)
+    {
+        airportRows.emplace(airportIdentifiers[row], row);
+    }
+    _airportSchedules.assign(airportIdentifiers.size(), 0);
+    _compiled.assign(airportIdentifiers.size(), 0);
+    if (!attendance.isValid())
+    {
+        return;
+    }
+
+    // week zero never attended, so schedules of unattended rows and airports share it
+    std::unordered_map<std::string, uint32_t> weekIds;
+    weekIds.emplace(std::string(WORDS_PER_WEEK * sizeof(uint64_t), '\0'), 0);
+
+    // compile each distinct DAY and HOUR pair once; rows only differ in airport and MONTH
+    const CSV::Column airports = attendance.getColumn("ARPT_ID");
+    const CSV::Column months = attendance.getColumn("MONTH");
+    const CSV::Column days = attendance.getColumn("DAY");
+    const CSV::Column hours = attendance.getColumn("HOUR");
+
+    struct Entry
+    {
+        uint32_t airport;
+        uint32_t months;
+        uint32_t week;      // NO_WEEK when the row could not be compiled
+    };
+    std::vector<Entry> entries;
+    entries.reserve(airports.get().size());
+    std::unordered_map<std::string, uint32_t> pairWeeks;
+    std::vector<uint64_t> bits(WORDS_PER_WEEK);
+    for (size_t row = 0; row < airports.get().size(); row++)
+    {
+        std::unordered_map<std::string, size_t>::const_iterator airport = airportRows.find(airports.get()[row]);
+        if (airport == airportRows.end())
+        {
+            continue;
+        }
+
+        const std::string key = days.get()[row] + '\x1f' + hours.get()[row];
+        std::unordered_map<std::string, uint32_t>::const_iterator found = pairWeeks.find(key);
+        if (found == pairWeeks.end())
+        {
+            std::fill(bits.begin(), bits.end(), 0);
+            const uint32_t week = Detail::CompileAttendanceWeek(days.get()[row], hours.get()[row], bits.data()) ? Detail::InternAttendanceWeek(bits.data(), _weeks, weekIds) : Detail::NO_WEEK;
+            found = pairWeeks.emplace(key, week).first;
+        }
+
+        const tl::optional<uint32_t> monthMask = Detail::ParseAttendanceNames(months.get()[row], Detail::AttendanceMonths, 12);
+        entries.push_back({ static_cast<uint32_t>(airport->second), monthMask ? *monthMask : 0, monthMask ? found->second : Detail::NO_WEEK });
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.airport != b.airport ? a.airport < b.airport : a.week < b.week;
+    });
+
+    // per airport and month, the union of the weeks of the rows covering that month
+    std::unordered_map<std::string, uint32_t> unionWeeks;
+    std::unordered_map<std::string, uint32_t> scheduleIds;
+    scheduleIds.emplace(std::string(12 * sizeof(uint32_t), '\0'), 0);
+    for (size_t begin = 0; begin < entries.size();)
+    {
+        const uint32_t airport = entries[begin].airport;
+        size_t end = begin;
+        bool compiled = true;
+        while (end < entries.size() && entries[end].airport == airport)
+        {
+            compiled = compiled && entries[end].week != Detail::NO_WEEK;
+            end++;
+        }
+
+        uint32_t schedule[12];
+        for (size_t month = 0; month < 12; month++)
+        {
+            // entries are sorted by week, so the list below comes out sorted and can key the union
+            std::vector<uint32_t> covering;
+            for (size_t i = begin; i < end; i++)
+            {
+                const Entry &entry = entries[i];
+                if (entry.week != Detail::NO_WEEK && entry.week != 0 && (entry.months & (1u << month)) != 0 && (covering.empty() || covering.back() != entry.week))
+                {
+                    covering.push_back(entry.week);
+                }
+            }
+
+            if (covering.size() <= 1)
+            {
+                schedule[month] = covering.empty() ? 0 : covering[0];
+                continue;
+            }
+
+            const std::string key(reinterpret_cast<const char *>(covering.data()), covering.size() * sizeof(uint32_t));
+            std::unordered_map<std::string, uint32_t>::const_iterator found = unionWeeks.find(key);
+            if (found == unionWeeks.end())
+            {
+                std::fill(bits.begin(), bits.end(), 0);
+                for (uint32_t week : covering)
+                {
+                    for (size_t word = 0; word < WORDS_PER_WEEK; word++)
+                    {
+                        bits[word] |= _weeks[week * WORDS_PER_WEEK + word];
+                    }
+                }
+                found = unionWeeks.emplace(key, Detail::InternAttendanceWeek(bits.data(), _weeks, weekIds)).first;
+            }
+            schedule[month] = found->second;
+        }
+
+        const std::string key(reinterpret_cast<const char *>(schedule), sizeof(schedule));
+        std::unordered_map<std::string, uint32_t>::const_iterator found = scheduleIds.find(key);
+        if (found == scheduleIds.end())
+        {
+            found = scheduleIds.emplace(key, static_cast<uint32_t>(_scheduleWeeks.size() / 12)).first;
+            _scheduleWeeks.insert(_scheduleWeeks.end(), schedule, schedule + 12);
+        }
+        _airportSchedules[airport] = found->second;
+        _compiled[airport] = compiled ? 1 : 0;
+        begin = end;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AttendanceTable::getAirportCount() const
+{
+    return _airportSchedules.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AttendanceTable::getScheduleCount() const
+{
+    return _scheduleWeeks.size() / 12;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t AttendanceTable::getWeekCount() const
+{
+    return _weeks.size() / WORDS_PER_WEEK;
+}
+
+// ----------------------------------------------------------------------------
+
+bool AttendanceTable::isCompiled(size_t airport) const
+{
+    return airport < _compiled.size() && _compiled[airport] != 0;
+}
+
+// ----------------------------------------------------------------------------
+
+bool AttendanceTable::isAttended(size_t airport, size_t month, size_t minute) const
+{
+    const size_t week = _scheduleWeeks[_airportSchedules[airport] * 12 + month];
+    return ((_weeks[week * WORDS_PER_WEEK + minute / 64] >> (minute % 64)) & 1) != 0;
+}
+
+// ----------------------------------------------------------------------------
+
+bool AttendanceTable::isAttendedAt(size_t airport, const std::tm &localTime) const
+{
+    if (airport >= _airportSchedules.size() || !Detail::IsAttendanceTime(localTime))
+    {
+        return false;
+    }
+    return isAttended(airport, localTime.tm_mon, localTime.tm_wday * MINUTES_PER_DAY + localTime.tm_hour * 60 + localTime.tm_min);
+}
+
+// ----------------------------------------------------------------------------
+
+void AttendanceTable::isAttendedAt(const std::tm &localTime, std::vector<uint8_t> &out) const
+{
+    out.assign(_airportSchedules.size(), 0);
+    if (!Detail::IsAttendanceTime(localTime))
+    {
+        return;
+    }
+
+    // one bit test per distinct schedule, then a gather per airport
+    const size_t minute = localTime.tm_wday * MINUTES_PER_DAY + localTime.tm_hour * 60 + localTime.tm_min;
+    std::vector<uint8_t> attended(getScheduleCount());
+    for (size_t schedule = 0; schedule < attended.size(); schedule++)
+    {
+        const size_t week = _scheduleWeeks[schedule * 12 + localTime.tm_mon];
+        attended[schedule] = static_cast<uint8_t>((_weeks[week * WORDS_PER_WEEK + minute / 64] >> (minute % 64)) & 1);
+    }
+    for (size_t airport = 0; airport < out.size(); airport++)
+    {
+        out[airport] = attended[_airportSchedules[airport]];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<uint8_t> AttendanceTable::isAttendedAt(const std::vector<size_t> &airports, const std::vector<std::tm> &localTimes) const
+{
+    std::vector<uint8_t> out(airports.size(), 0);
+    for (size_t i = 0; i < airports.size() && i < localTimes.size(); i++)
+    {
+        out[i] = isAttendedAt(airports[i], localTimes[i]) ? 1 : 0;
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
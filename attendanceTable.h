@@ -0,0 +1,93 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// APT_ATT schedules compiled into weekly bitsets with one bit per minute, one
+// bitset per month of the year.  Each airport's rows are OR-ed together, and
+// identical weeks and identical years are stored once, so an airport costs a
+// single index.  MONTH and DAY take "ALL", single names such as "JAN" or "MON"
+// and ranges such as "APR-OCT", "FRI-MON" or "NOV-MAR"; HOUR takes "ALL",
+// "UNATNDD" and windows such as "0600-2200", where a window ending at or
+// before its start runs past midnight into the next day.  Any of them may be a
+// comma separated list.  Times are local to the airport.
+class AttendanceTable
+{
+public:
+    static constexpr size_t MINUTES_PER_DAY = 24 * 60;
+    static constexpr size_t MINUTES_PER_WEEK = 7 * MINUTES_PER_DAY;
+    static constexpr size_t WORDS_PER_WEEK = (MINUTES_PER_WEEK + 63) / 64;
+
+    AttendanceTable();
+    AttendanceTable(const CSV::File& base, const CSV::File& attendance);
+
+    size_t getAirportCount() const;
+    size_t getScheduleCount() const;    // distinct compiled years
+    size_t getWeekCount() const;        // distinct compiled weeks
+
+    // false when the airport has no APT_ATT rows or some of its rows could not be
+    // compiled (e.g. "SR-SS"), in which case only the compiled rows count as attended
+    bool isCompiled(size_t airport) const;
+
+    // whether the airport in APT_BASE row airport is attended at the local time; only
+    // tm_mon, tm_wday, tm_hour and tm_min are read
+    bool isAttendedAt(size_t airport, const std::tm& localTime) const;
+
+    // every airport at one time; out is resized to getAirportCount(), 1 when attended
+    void isAttendedAt(const std::tm& localTime, std::vector<uint8_t>& out) const;
+
+    // a subset of airports, each at its own local time
+    std::vector<uint8_t> isAttendedAt(const std::vector<size_t>& airports, const std::vector<std::tm>& localTimes) const;
+
+private:
+    bool isAttended(size_t airport, size_t month, size_t minute) const;
+
+private:
+    std::vector<uint32_t> _airportSchedules;    // per airport, into _scheduleWeeks
+    std::vector<uint32_t> _scheduleWeeks;       // 12 per schedule, into _weeks
+    std::vector<uint64_t> _weeks;               // WORDS_PER_WEEK per week, week 0 never attended
+    std::vector<uint8_t> _compiled;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
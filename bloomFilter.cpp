@@ -0,0 +1,207 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "bloomFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr size_t BLOOM_BLOCK_WORDS = 8;
+constexpr size_t BLOOM_BLOCK_BITS = BLOOM_BLOCK_WORDS * 64;
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+BloomFilter::BloomFilter()
+    : _blockCount(0), _hashCount(0), _queries(0), _rejections(0), _falsePositives(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+BloomFilter::BloomFilter(const std::vector<std::string> &keys, double falsePositiveRate)
+    : _queries(0), _rejections(0), _falsePositives(0)
+{
+    // optimal bit and hash counts for a plain Bloom filter; blocking raises the
+    // false positive rate slightly above the requested one
+    const double ln2 = std::log(2.0);
+    const double count = static_cast<double>(std::max<size_t>(1, keys.size()));
+    const double rate = std::min(0.5, std::max(1e-6, falsePositiveRate));
+    const double bits = -count * std::log(rate) / (ln2 * ln2);
+    _blockCount = std::max<size_t>(1, static_cast<size_t>(std::ceil(bits / Detail::BLOOM_BLOCK_BITS)));
+    _hashCount = std::max<size_t>(1, std::min<size_t>(16, static_cast<size_t>(std::round(bits / count * ln2))));
+    _words.assign(_blockCount * Detail::BLOOM_BLOCK_WORDS, 0);
+
+    for (const std::string &key : keys)
+    {
+        if (!key.empty())
+        {
+            add(key);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+BloomFilter::BloomFilter(const BloomFilter &other)
+    : _words(other._words), _blockCount(other._blockCount), _hashCount(other._hashCount),
+      _queries(other._queries.load()), _rejections(other._rejections.load()), _falsePositives(other._falsePositives.load())
+{
+}
+
+// ----------------------------------------------------------------------------
+
+BloomFilter &BloomFilter::operator=(const BloomFilter &other)
+{
+    _words = other._words;
+    _blockCount = other._blockCount;
+    _hashCount = other._hashCount;
+    _queries = other._queries.load();
+    _rejections = other._rejections.load();
+    _falsePositives = other._falsePositives.load();
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t BloomFilter::getBitCount() const
+{
+    return _words.size() * 64;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t BloomFilter::getHashCount() const
+{
+    return _hashCount;
+}
+
+// ----------------------------------------------------------------------------
+
+uint64_t BloomFilter::Hash(const std::string &key)
+{
+    // FNV-1a followed by the murmur3 finalizer to spread short keys over all bits
+    uint64_t out = 14695981039346656037ull;
+    for (char c : key)
+    {
+        out = (out ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    out ^= out >> 33;
+    out *= 0xff51afd7ed558ccdull;
+    out ^= out >> 33;
+    out *= 0xc4ceb9fe1a85ec53ull;
+    out ^= out >> 33;
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+void BloomFilter::add(const std::string &key)
+{
+    const uint64_t hash = Hash(key);
+    uint64_t *block = _words.data() + ((hash >> 32) * _blockCount >> 32) * Detail::BLOOM_BLOCK_WORDS;
+    uint32_t bit = static_cast<uint32_t>(hash);
+    const uint32_t step = static_cast<uint32_t>(hash >> 23) | 1;
+    for (size_t i = 0; i < _hashCount; i++)
+    {
+        const uint32_t position = bit % Detail::BLOOM_BLOCK_BITS;
+        block[position / 64] |= 1ull << (position % 64);
+        bit += step;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool BloomFilter::mayContain(const std::string &key) const
+{
+    _queries.fetch_add(1, std::memory_order_relaxed);
+    if (_words.empty())
+    {
+        _rejections.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const uint64_t hash = Hash(key);
+    const uint64_t *block = _words.data() + ((hash >> 32) * _blockCount >> 32) * Detail::BLOOM_BLOCK_WORDS;
+    uint32_t bit = static_cast<uint32_t>(hash);
+    const uint32_t step = static_cast<uint32_t>(hash >> 23) | 1;
+    for (size_t i = 0; i < _hashCount; i++)
+    {
+        const uint32_t position = bit % Detail::BLOOM_BLOCK_BITS;
+        if ((block[position / 64] & (1ull << (position % 64))) == 0)
+        {
+            _rejections.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        bit += step;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void BloomFilter::recordFalsePositive() const
+{
+    _falsePositives.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+BloomFilterStatistics BloomFilter::getStatistics() const
+{
+    return { _queries.load(), _rejections.load(), _falsePositives.load() };
+}
+
+// ----------------------------------------------------------------------------
+
+void BloomFilter::resetStatistics()
+{
+    _queries = 0;
+    _rejections = 0;
+    _falsePositives = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
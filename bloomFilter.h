@@ -0,0 +1,92 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+struct BloomFilterStatistics
+{
+    uint64_t queries;
+    uint64_t rejections;        // queries answered "definitely absent"
+    uint64_t falsePositives;    // passed queries later reported absent by the caller
+};
+
+// ----------------------------------------------------------------------------
+
+// Cache-blocked Bloom filter: every key sets its bits within a single 512 bit
+// block, so a query touches one cache line.  Queries are counted so callers
+// can see how much traffic the filter turns away.
+class BloomFilter
+{
+public:
+    BloomFilter();
+    BloomFilter(const std::vector<std::string>& keys, double falsePositiveRate = 0.01);
+    BloomFilter(const BloomFilter& other);
+    BloomFilter& operator=(const BloomFilter& other);
+
+    size_t getBitCount() const;
+    size_t getHashCount() const;
+
+    // false means the key was never added; true may be a false positive
+    bool mayContain(const std::string& key) const;
+
+    // reports that a key passed by mayContain was not actually present
+    void recordFalsePositive() const;
+
+    BloomFilterStatistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    static uint64_t Hash(const std::string& key);
+    void add(const std::string& key);
+
+private:
+    std::vector<uint64_t> _words;   // 8 words per block
+    size_t _blockCount;
+    size_t _hashCount;
+
+    mutable std::atomic<uint64_t> _queries;
+    mutable std::atomic<uint64_t> _rejections;
+    mutable std::atomic<uint64_t> _falsePositives;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
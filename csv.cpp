@@ -32,7 +32,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "csv.h"
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include <sstream>
 
 namespace NASR
@@ -184,6 +186,363 @@ const std::string &Row::get(const std::string &columnName) const
 
 // ----------------------------------------------------------------------------
 
+const char INDEX_KEY_SEPARATOR = '\x1f';
+
+// ----------------------------------------------------------------------------
+
+// FNV-1a over the values joined by INDEX_KEY_SEPARATOR, without joining them
+uint64_t HashIndexKey(const std::string *values, size_t count)
+{
+    uint64_t out = 14695981039346656037ull;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i != 0)
+        {
+            out = (out ^ static_cast<uint8_t>(INDEX_KEY_SEPARATOR)) * 1099511628211ull;
+        }
+        for (char c : values[i])
+        {
+            out = (out ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+Index::Index()
+{
+}
+
+// ----------------------------------------------------------------------------
+
+Index::Index(const std::vector<std::string> &columns, const std::vector<size_t> &columnIndices)
+    : _columns(columns), _columnIndices(columnIndices)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<std::string> &Index::getColumns() const
+{
+    return _columns;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t Index::getKeyCount() const
+{
+    return _hashes.size();
+}
+
+// ----------------------------------------------------------------------------
+
+void Index::add(const std::vector<std::string> &row)
+{
+    std::string key;
+    for (size_t i = 0; i < _columnIndices.size(); i++)
+    {
+        if (i != 0)
+        {
+            key.push_back(INDEX_KEY_SEPARATOR);
+        }
+        std::string value = row[_columnIndices[i]];
+        Clean(value);
+        key += value;
+    }
+    _pendingKeys.push_back(std::move(key));
+}
+
+// ----------------------------------------------------------------------------
+
+void Index::finalize()
+{
+    const size_t rowCount = _pendingKeys.size();
+    size_t slotCount = 8;
+    while (slotCount < rowCount * 2)
+    {
+        slotCount *= 2;
+    }
+    const size_t mask = slotCount - 1;
+    _slots.assign(slotCount, 0);
+    _hashes.clear();
+    _keyOffsets.assign(1, 0);
+    _keyData.clear();
+
+    // assign every row to a key, creating keys in order of first appearance
+    std::vector<uint32_t> rowKeys(rowCount);
+    std::vector<uint32_t> counts;
+    for (size_t row = 0; row < rowCount; row++)
+    {
+        const std::string &key = _pendingKeys[row];
+        const uint64_t hash = HashIndexKey(&key, 1);
+        size_t slot = static_cast<size_t>(hash) & mask;
+        while (_slots[slot] != 0)
+        {
+            const uint32_t candidate = _slots[slot] - 1;
+            if (_hashes[candidate] == hash && _keyData.compare(_keyOffsets[candidate], _keyOffsets[candidate + 1] - _keyOffsets[candidate], key) == 0)
+            {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        if (_slots[slot] == 0)
+        {
+            _slots[slot] = static_cast<uint32_t>(_hashes.size() + 1);
+            _hashes.push_back(hash);
+            _keyData += key;
+            _keyOffsets.push_back(static_cast<uint32_t>(_keyData.size()));
+            counts.push_back(0);
+        }
+        rowKeys[row] = _slots[slot] - 1;
+        counts[rowKeys[row]]++;
+    }
+
+    // rows grouped by key, ascending within each key
+    _rowOffsets.assign(counts.size() + 1, 0);
+    for (size_t key = 0; key < counts.size(); key++)
+    {
+        _rowOffsets[key + 1] = _rowOffsets[key] + counts[key];
+    }
+    std::vector<uint32_t> cursor(_rowOffsets.begin(), _rowOffsets.end() - 1);
+    _rows.resize(rowCount);
+    for (size_t row = 0; row < rowCount; row++)
+    {
+        _rows[cursor[rowKeys[row]]++] = static_cast<uint32_t>(row);
+    }
+
+    _pendingKeys.clear();
+    _pendingKeys.shrink_to_fit();
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan Index::lookup(const std::string &value) const
+{
+    return find(&value, 1);
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan Index::lookupComposite(const std::vector<std::string> &values) const
+{
+    return find(values.data(), values.size());
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan Index::find(const std::string *values, size_t count) const
+{
+    if (_slots.empty() || count != _columnIndices.size())
+    {
+        return RowSpan();
+    }
+
+    const uint64_t hash = HashIndexKey(values, count);
+    const size_t mask = _slots.size() - 1;
+    for (size_t slot = static_cast<size_t>(hash) & mask; _slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const uint32_t key = _slots[slot] - 1;
+        if (_hashes[key] != hash)
+        {
+            continue;
+        }
+
+        // compare the stored key against the values piece by piece
+        size_t position = _keyOffsets[key];
+        bool match = true;
+        for (size_t i = 0; i < count && match; i++)
+        {
+            if (i != 0)
+            {
+                match = position < _keyOffsets[key + 1] && _keyData[position++] == INDEX_KEY_SEPARATOR;
+            }
+            match = match && position + values[i].size() <= _keyOffsets[key + 1] && _keyData.compare(position, values[i].size(), values[i]) == 0;
+            position += values[i].size();
+        }
+        if (match && position == _keyOffsets[key + 1])
+        {
+            return RowSpan(_rows.data() + _rowOffsets[key], _rows.data() + _rowOffsets[key + 1]);
+        }
+    }
+    return RowSpan();
+}
+
+// ----------------------------------------------------------------------------
+
+NumericIndex::NumericIndex()
+    : _columnIndex(0), _blockSize(1024)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+NumericIndex::NumericIndex(const std::string &column, size_t columnIndex, size_t blockSize)
+    : _column(column), _columnIndex(columnIndex), _blockSize(std::max<size_t>(1, blockSize))
+{
+}
+
+// ----------------------------------------------------------------------------
+
+const std::string &NumericIndex::getColumn() const
+{
+    return _column;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t NumericIndex::size() const
+{
+    return _values.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t NumericIndex::getValueCount() const
+{
+    return _sortedRows.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t NumericIndex::getBlockSize() const
+{
+    return _blockSize;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t NumericIndex::getBlockCount() const
+{
+    return _blockMinimum.size();
+}
+
+// ----------------------------------------------------------------------------
+
+void NumericIndex::add(const std::vector<std::string> &row)
+{
+    std::string value = row[_columnIndex];
+    Clean(value);
+
+    // empty values are common, so skip them before paying for a parse failure
+    const tl::optional<double> parsed = value.empty() ? tl::nullopt : Utils::ParseOptional<double>(value);
+    _values.push_back(parsed ? *parsed : std::numeric_limits<double>::quiet_NaN());
+}
+
+// ----------------------------------------------------------------------------
+
+void NumericIndex::finalize()
+{
+    _sortedRows.clear();
+    for (size_t row = 0; row < _values.size(); row++)
+    {
+        if (!std::isnan(_values[row]))
+        {
+            _sortedRows.push_back(static_cast<uint32_t>(row));
+        }
+    }
+    std::stable_sort(_sortedRows.begin(), _sortedRows.end(), [this](uint32_t a, uint32_t b)
+    {
+        return _values[a] < _values[b];
+    });
+    _sortedValues.clear();
+    _sortedValues.reserve(_sortedRows.size());
+    for (uint32_t row : _sortedRows)
+    {
+        _sortedValues.push_back(_values[row]);
+    }
+
+    const size_t blockCount = (_values.size() + _blockSize - 1) / _blockSize;
+    _blockMinimum.assign(blockCount, std::numeric_limits<double>::infinity());
+    _blockMaximum.assign(blockCount, -std::numeric_limits<double>::infinity());
+    for (size_t row = 0; row < _values.size(); row++)
+    {
+        const double value = _values[row];
+        if (!std::isnan(value))
+        {
+            const size_t block = row / _blockSize;
+            _blockMinimum[block] = std::min(_blockMinimum[block], value);
+            _blockMaximum[block] = std::max(_blockMaximum[block], value);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+double NumericIndex::getValue(size_t row) const
+{
+    return _values[row];
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<double> &NumericIndex::getValues() const
+{
+    return _values;
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan NumericIndex::between(double minimum, double maximum) const
+{
+    if (!(minimum <= maximum))
+    {
+        return RowSpan();
+    }
+    const size_t begin = std::lower_bound(_sortedValues.begin(), _sortedValues.end(), minimum) - _sortedValues.begin();
+    const size_t end = std::upper_bound(_sortedValues.begin() + begin, _sortedValues.end(), maximum) - _sortedValues.begin();
+    return RowSpan(_sortedRows.data() + begin, _sortedRows.data() + end);
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan NumericIndex::atLeast(double minimum) const
+{
+    return between(minimum, std::numeric_limits<double>::infinity());
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan NumericIndex::atMost(double maximum) const
+{
+    return between(-std::numeric_limits<double>::infinity(), maximum);
+}
+
+// ----------------------------------------------------------------------------
+
+bool NumericIndex::blockMayMatch(size_t block, double minimum, double maximum) const
+{
+    return _blockMinimum[block] <= maximum && _blockMaximum[block] >= minimum;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> NumericIndex::selectRows(double minimum, double maximum) const
+{
+    std::vector<size_t> out;
+    for (size_t block = 0; block < _blockMinimum.size(); block++)
+    {
+        if (!blockMayMatch(block, minimum, maximum))
+        {
+            continue;
+        }
+
+        const size_t end = std::min(_values.size(), (block + 1) * _blockSize);
+        for (size_t row = block * _blockSize; row < end; row++)
+        {
+            // NaN fails both comparisons
+            if (_values[row] >= minimum && _values[row] <= maximum)
+            {
+                out.push_back(row);
+            }
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
 File::File() : _valid(false)
 {
 }
@@ -197,6 +556,13 @@ File::File(const std::string &filename)
 
 // ----------------------------------------------------------------------------
 
+File::File(const std::string &filename, const std::vector<std::vector<std::string>> &indexes)
+{
+    parseFile(filename, indexes);
+}
+
+// ----------------------------------------------------------------------------
+
 bool File::isValid() const
 {
     return _valid;
@@ -211,10 +577,12 @@ const std::string &File::getFilename() const
 
 // ----------------------------------------------------------------------------
 
-bool File::parseFile(const std::string &filename)
+bool File::parseFile(const std::string &filename, const std::vector<std::vector<std::string>> &indexes)
 {
     _filename = filename;
     _rows.clear();
+    _indexes.clear();
+    _numericIndexes.clear();
     _valid = false;
 
     std::ifstream istrm(filename);
@@ -236,6 +604,11 @@ bool File::parseFile(const std::string &filename)
             _header = std::make_shared<Header>(parseLine(line));
             headerSize = _header->length();
             _valid = true;
+
+            for (const std::vector<std::string> &columns : indexes)
+            {
+                _indexes.push_back(makeIndex(columns));
+            }
         }
         else
         {
@@ -245,10 +618,19 @@ bool File::parseFile(const std::string &filename)
                 // skip lines where the size doesn't match
                 continue;
             }
+            for (Index &index : _indexes)
+            {
+                index.add(items);
+            }
             _rows.emplace_back(std::move(items));
         }
     }
 
+    for (Index &index : _indexes)
+    {
+        index.finalize();
+    }
+
     return _valid;
 }
 
@@ -290,6 +672,124 @@ std::vector<Row> File::getRows(const std::vector<size_t> &indices) const
 
 // ----------------------------------------------------------------------------
 
+void File::addIndex(const std::vector<std::string> &columns)
+{
+    if (hasIndex(columns))
+    {
+        return;
+    }
+
+    Index index = makeIndex(columns);
+    for (const std::vector<std::string> &row : _rows)
+    {
+        index.add(row);
+    }
+    index.finalize();
+    _indexes.push_back(std::move(index));
+}
+
+// ----------------------------------------------------------------------------
+
+bool File::hasIndex(const std::vector<std::string> &columns) const
+{
+    for (const Index &index : _indexes)
+    {
+        if (index.getColumns() == columns)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan File::lookup(const std::string &column, const std::string &value) const
+{
+    for (const Index &index : _indexes)
+    {
+        if (index.getColumns().size() == 1 && index.getColumns()[0] == column)
+        {
+            return index.lookup(value);
+        }
+    }
+    throw std::out_of_range("no index on column " + column);
+}
+
+// ----------------------------------------------------------------------------
+
+RowSpan File::lookupComposite(const std::vector<std::string> &columns, const std::vector<std::string> &values) const
+{
+    for (const Index &index : _indexes)
+    {
+        if (index.getColumns() == columns)
+        {
+            return index.lookupComposite(values);
+        }
+    }
+    throw std::out_of_range("no index on the requested columns");
+}
+
+// ----------------------------------------------------------------------------
+
+void File::addNumericIndex(const std::string &column, size_t blockSize)
+{
+    if (hasNumericIndex(column))
+    {
+        return;
+    }
+
+    NumericIndex index(column, _header->getIndex(column), blockSize);
+    for (const std::vector<std::string> &row : _rows)
+    {
+        index.add(row);
+    }
+    index.finalize();
+    _numericIndexes.push_back(std::move(index));
+}
+
+// ----------------------------------------------------------------------------
+
+bool File::hasNumericIndex(const std::string &column) const
+{
+    for (const NumericIndex &index : _numericIndexes)
+    {
+        if (index.getColumn() == column)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+const NumericIndex &File::getNumericIndex(const std::string &column) const
+{
+    for (const NumericIndex &index : _numericIndexes)
+    {
+        if (index.getColumn() == column)
+        {
+            return index;
+        }
+    }
+    throw std::out_of_range("no numeric index on column " + column);
+}
+
+// ----------------------------------------------------------------------------
+
+Index File::makeIndex(const std::vector<std::string> &columns) const
+{
+    std::vector<size_t> columnIndices;
+    for (const std::string &column : columns)
+    {
+        columnIndices.push_back(_header->getIndex(column));
+    }
+    return Index(columns, columnIndices);
+}
+
+// ----------------------------------------------------------------------------
+
 std::vector<std::string> File::parseLine(const std::string &line, size_t sizeHint) const
 {
     std::vector<std::string> items;
@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <optional.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -122,6 +123,24 @@ T Parse(const std::string& data)
     return instance;
 }
 
+template <typename T>
+tl::optional<T> ParseOptional(const std::string& data)
+{
+    try
+    {
+        return Parse<T>(data);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return tl::nullopt;
+    }
+    catch (const std::out_of_range&)
+    {
+        return tl::nullopt;
+    }
+    return tl::nullopt;
+}
+
 } // namespace Utils
 
 // ----------------------------------------------------------------------------
@@ -242,19 +261,7 @@ public:
     template <typename T>
     tl::optional<T> getOptional(size_t index) const
     {
-        try
-        {
-            return Utils::Parse<T>(_data[index]);
-        }
-        catch (const std::invalid_argument&)
-        {
-            return tl::nullopt;
-        }
-        catch (const std::out_of_range&)
-        {
-            return tl::nullopt;
-        }
-        return tl::nullopt;
+        return Utils::ParseOptional<T>(_data[index]);
     }
 
     template <typename T>
@@ -307,12 +314,119 @@ private:
 
 // ----------------------------------------------------------------------------
 
+// row indices sharing one key of an Index, or falling within a range of a NumericIndex
+class RowSpan
+{
+public:
+    RowSpan() : _begin(nullptr), _end(nullptr) {}
+    RowSpan(const uint32_t* begin, const uint32_t* end) : _begin(begin), _end(end) {}
+
+    const uint32_t* begin() const { return _begin; }
+    const uint32_t* end() const { return _end; }
+    size_t size() const { return _end - _begin; }
+    bool empty() const { return _begin == _end; }
+    size_t operator[](size_t index) const { return _begin[index]; }
+
+private:
+    const uint32_t* _begin;
+    const uint32_t* _end;
+};
+
+// ----------------------------------------------------------------------------
+
+// Open-addressing hash index from the cleaned values of one or more columns
+// to the rows holding them.  Keys are added row by row and grouped by
+// finalize(); each distinct key keeps its rows contiguously, so a lookup is
+// a single probe sequence returning a RowSpan.
+class Index
+{
+public:
+    Index();
+    Index(const std::vector<std::string>& columns, const std::vector<size_t>& columnIndices);
+
+    const std::vector<std::string>& getColumns() const;
+    size_t getKeyCount() const;
+
+    void add(const std::vector<std::string>& row);
+    void finalize();
+
+    RowSpan lookup(const std::string& value) const;
+    RowSpan lookupComposite(const std::vector<std::string>& values) const;
+
+private:
+    RowSpan find(const std::string* values, size_t count) const;
+
+private:
+    std::vector<std::string> _columns;
+    std::vector<size_t> _columnIndices;
+    std::vector<std::string> _pendingKeys;  // one per added row until finalize()
+
+    std::vector<uint32_t> _slots;           // key + 1, or 0 when empty; size is a power of two
+    std::vector<uint64_t> _hashes;          // per key
+    std::vector<uint32_t> _keyOffsets;      // per key + 1, into _keyData
+    std::string _keyData;                   // column values of each key separated by '\x1f'
+    std::vector<uint32_t> _rowOffsets;      // per key + 1, into _rows
+    std::vector<uint32_t> _rows;
+};
+
+// ----------------------------------------------------------------------------
+
+// Typed copy of a numeric column with a value-sorted permutation of its rows
+// and per-block min/max zone maps.  Range queries on the permutation are two
+// binary searches; scans in row order visit only blocks whose zone overlaps
+// the range.  Rows whose value is missing or not numeric are left out of both.
+class NumericIndex
+{
+public:
+    NumericIndex();
+    NumericIndex(const std::string& column, size_t columnIndex, size_t blockSize = 1024);
+
+    const std::string& getColumn() const;
+    size_t size() const;
+    size_t getValueCount() const;   // rows with a numeric value
+    size_t getBlockSize() const;
+    size_t getBlockCount() const;
+
+    void add(const std::vector<std::string>& row);
+    void finalize();
+
+    // value of a row, or NaN when missing
+    double getValue(size_t row) const;
+    const std::vector<double>& getValues() const;
+
+    // rows in ascending value order with minimum <= value <= maximum
+    RowSpan between(double minimum, double maximum) const;
+    RowSpan atLeast(double minimum) const;
+    RowSpan atMost(double maximum) const;
+
+    // rows in ascending row order with minimum <= value <= maximum, skipping blocks outside the range
+    std::vector<size_t> selectRows(double minimum, double maximum) const;
+
+    // whether any row of the block could fall within the range
+    bool blockMayMatch(size_t block, double minimum, double maximum) const;
+
+private:
+    std::string _column;
+    size_t _columnIndex;
+    size_t _blockSize;
+    std::vector<double> _values;        // row order, NaN when missing
+    std::vector<double> _sortedValues;
+    std::vector<uint32_t> _sortedRows;
+    std::vector<double> _blockMinimum;  // +infinity for blocks without values
+    std::vector<double> _blockMaximum;  // -infinity for blocks without values
+};
+
+// ----------------------------------------------------------------------------
+
 class File
 {
 public:
     File();
     File(const std::string& filename);
 
+    // indexes lists the column sets to index; keys are extracted while the file is parsed
+    File(const std::string& filename, const std::vector<std::vector<std::string>>& indexes);
+
     bool isValid() const;
     const std::string& getFilename() const;
 
@@ -323,15 +437,29 @@ public:
     Column operator[](const std::string& columnName) const { return getColumn(columnName); }
     Row operator[](size_t index) const { return getRow(index); }
 
+    // hash indexes over one or more columns; lookups on columns without an index throw std::out_of_range
+    void addIndex(const std::vector<std::string>& columns);
+    bool hasIndex(const std::vector<std::string>& columns) const;
+    RowSpan lookup(const std::string& column, const std::string& value) const;
+    RowSpan lookupComposite(const std::vector<std::string>& columns, const std::vector<std::string>& values) const;
+
+    // sorted numeric indexes with zone maps; getNumericIndex throws std::out_of_range when absent
+    void addNumericIndex(const std::string& column, size_t blockSize = 1024);
+    bool hasNumericIndex(const std::string& column) const;
+    const NumericIndex& getNumericIndex(const std::string& column) const;
+
 private:
-    bool parseFile(const std::string& name);
+    bool parseFile(const std::string& name, const std::vector<std::vector<std::string>>& indexes = std::vector<std::vector<std::string>>());
     std::vector<std::string> parseLine(const std::string& line, size_t sizeHint = 0) const;
+    Index makeIndex(const std::vector<std::string>& columns) const;
 
 private:
     bool _valid;
     Header::Ptr _header;
     std::vector<std::vector<std::string>> _rows;
     std::string _filename;
+    std::vector<Index> _indexes;
+    std::vector<NumericIndex> _numericIndexes;
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,249 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "frequencyIndex.h"
+#include "csv.h"
+#include "geo.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+// keys for DME channels that have no paired VHF frequency
+constexpr uint32_t UNPAIRED_CHANNEL = 0x80000000;
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+FrequencyIndex::FrequencyIndex()
+    : _offsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+FrequencyIndex::FrequencyIndex(std::vector<Entry> entries)
+{
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+    {
+        return a.frequency < b.frequency;
+    });
+
+    _offsets.push_back(0);
+    for (const Entry &entry : entries)
+    {
+        if (_frequencies.empty() || _frequencies.back() != entry.frequency)
+        {
+            if (!_frequencies.empty())
+            {
+                _offsets.push_back(static_cast<uint32_t>(_rows.size()));
+            }
+            _frequencies.push_back(entry.frequency);
+        }
+        _components.push_back(entry.component);
+        _rows.push_back(entry.row);
+        _latitudes.push_back(entry.location.getLatitude());
+        _longitudes.push_back(entry.location.getLongitude());
+    }
+    if (!_frequencies.empty())
+    {
+        _offsets.push_back(static_cast<uint32_t>(_rows.size()));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t FrequencyIndex::size() const
+{
+    return _rows.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t FrequencyIndex::getFrequencyCount() const
+{
+    return _frequencies.size();
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<TunedFacility> FrequencyIndex::query(uint32_t frequency, const Data::LatitudeLongitude &position, double range) const
+{
+    std::vector<TunedFacility> out;
+    std::vector<uint32_t>::const_iterator search = std::lower_bound(_frequencies.begin(), _frequencies.end(), frequency);
+    if (search == _frequencies.end() || *search != frequency || !position.valid())
+    {
+        return out;
+    }
+
+    const size_t group = search - _frequencies.begin();
+    const Geo::BoundingBox box = Geo::BoundingBox::Around(position, range);
+    for (size_t i = _offsets[group]; i < _offsets[group + 1]; i++)
+    {
+        if (!box.contains(_latitudes[i], _longitudes[i]))
+        {
+            continue;
+        }
+        const double distance = Geo::Distance(position.getLatitude(), position.getLongitude(), _latitudes[i], _longitudes[i]);
+        if (distance <= range)
+        {
+            out.push_back({ _components[i], _rows[i], distance });
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](const TunedFacility &a, const TunedFacility &b)
+    {
+        return a.distance < b.distance;
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::vector<TunedFacility>> FrequencyIndex::query(const std::vector<TuningQuery> &queries, double range, size_t threads) const
+{
+    std::vector<std::vector<TunedFacility>> out(queries.size());
+    Parallel::For(queries.size(), threads, [this, &queries, &out, range](size_t begin, size_t end, size_t)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            out[i] = query(queries[i].frequency, queries[i].position, range);
+        }
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<uint32_t> FrequencyIndex::ParseFrequency(const std::string &megahertz)
+{
+    const tl::optional<double> value = megahertz.empty() ? tl::nullopt : CSV::Utils::ParseOptional<double>(megahertz);
+    if (!value || *value <= 0.0)
+    {
+        return tl::nullopt;
+    }
+    return static_cast<uint32_t>(std::lround(*value * 1000.0));
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<uint32_t> FrequencyIndex::ParseKilohertz(const std::string &kilohertz)
+{
+    if (kilohertz.empty() || kilohertz.size() > 9 || !std::all_of(kilohertz.begin(), kilohertz.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }))
+    {
+        return tl::nullopt;
+    }
+    const uint32_t value = static_cast<uint32_t>(std::stoul(kilohertz));
+    if (value == 0)
+    {
+        return tl::nullopt;
+    }
+    return value;
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<uint32_t> FrequencyIndex::ParseChannel(const std::string &channel)
+{
+    // leading digits followed by the X or Y mode, e.g. 40X or 040Y
+    size_t i = 0;
+    uint32_t number = 0;
+    while (i < channel.size() && std::isdigit(static_cast<unsigned char>(channel[i])))
+    {
+        number = number * 10 + static_cast<uint32_t>(channel[i] - '0');
+        i++;
+    }
+    if (i == 0 || i + 1 != channel.size() || number == 0 || number > 126)
+    {
+        return tl::nullopt;
+    }
+    const char mode = static_cast<char>(std::toupper(static_cast<unsigned char>(channel[i])));
+    if (mode != 'X' && mode != 'Y')
+    {
+        return tl::nullopt;
+    }
+
+    // VHF pairing: 17-59 map to 108.00-112.15, 70-126 to 112.30-117.95, Y channels 50 kHz higher
+    const uint32_t offset = mode == 'Y' ? 50 : 0;
+    if (number >= 17 && number <= 59)
+    {
+        return 108000 + (number - 17) * 100 + offset;
+    }
+    if (number >= 70)
+    {
+        return 112300 + (number - 70) * 100 + offset;
+    }
+    return Detail::UNPAIRED_CHANNEL | (number << 1) | (mode == 'Y' ? 1 : 0);
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<uint32_t> FrequencyIndex::ParseTuning(const std::string &text)
+{
+    if (text.empty())
+    {
+        return tl::nullopt;
+    }
+    if (std::toupper(static_cast<unsigned char>(text.back())) == 'K')
+    {
+        return ParseKilohertz(text.substr(0, text.size() - 1));
+    }
+    if (std::isalpha(static_cast<unsigned char>(text.back())))
+    {
+        return ParseChannel(text);
+    }
+
+    // whole numbers below 1000 are locator frequencies in kHz; VHF is always given with decimals
+    const tl::optional<uint32_t> kilohertz = ParseKilohertz(text);
+    if (kilohertz && *kilohertz < 1000)
+    {
+        return kilohertz;
+    }
+    return ParseFrequency(text);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,118 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "data.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+enum class NavaidComponent
+{
+    LOCALIZER,
+    GLIDESLOPE,
+    DME,
+    MARKER
+};
+
+// ----------------------------------------------------------------------------
+
+struct TunedFacility
+{
+    NavaidComponent component;
+    size_t rowIndex;    // row within the component's file
+    double distance;    // nautical miles from the query position
+};
+
+// ----------------------------------------------------------------------------
+
+struct TuningQuery
+{
+    uint32_t frequency; // kHz, see FrequencyIndex::ParseTuning
+    Data::LatitudeLongitude position;
+};
+
+// ----------------------------------------------------------------------------
+
+// Navaid components grouped by tuning frequency in kHz, with the coordinates
+// of each group stored contiguously so a query is a binary search followed
+// by a short distance scan.  DME channels are keyed by their paired VHF
+// frequency, so tuning 110.30 finds channel 40X; channels without a VHF
+// pairing get keys of their own that only ParseChannel produces.
+class FrequencyIndex
+{
+public:
+    struct Entry
+    {
+        uint32_t frequency;
+        NavaidComponent component;
+        uint32_t row;
+        Data::LatitudeLongitude location;
+    };
+
+    FrequencyIndex();
+    FrequencyIndex(std::vector<Entry> entries);
+
+    size_t size() const;
+    size_t getFrequencyCount() const;
+
+    // facilities on the frequency within range nautical miles, nearest first
+    std::vector<TunedFacility> query(uint32_t frequency, const Data::LatitudeLongitude& position, double range) const;
+    std::vector<std::vector<TunedFacility>> query(const std::vector<TuningQuery>& queries, double range, size_t threads = 0) const;
+
+    // "110.30" (MHz), "338" (kHz, as ILS_MKR FREQ) or "40X" (DME channel) to an index key
+    static tl::optional<uint32_t> ParseFrequency(const std::string& megahertz);
+    static tl::optional<uint32_t> ParseKilohertz(const std::string& kilohertz);
+    static tl::optional<uint32_t> ParseChannel(const std::string& channel);
+
+    // any of the above: a trailing X or Y is a channel, a trailing K or a whole number
+    // below 1000 is kHz (e.g. "338K" or "338" for a compass locator), anything else MHz
+    static tl::optional<uint32_t> ParseTuning(const std::string& text);
+
+private:
+    std::vector<uint32_t> _frequencies;         // sorted, unique
+    std::vector<uint32_t> _offsets;             // _frequencies.size() + 1 entries
+    std::vector<NavaidComponent> _components;
+    std::vector<uint32_t> _rows;
+    std::vector<double> _latitudes;
+    std::vector<double> _longitudes;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,344 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "fuzzyIndex.h"
+#include "trigramIndex.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+uint64_t HashDelete(const std::string &text)
+{
+    // FNV-1a; collisions only add candidates that fail verification
+    uint64_t out = 14695981039346656037ull;
+    for (char c : text)
+    {
+        out = (out ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t DamerauLevenshtein(const std::string &a, const std::string &b, std::vector<uint32_t> &buffer)
+{
+    // unrestricted Damerau-Levenshtein (Lowrance-Wagner), which any chain of
+    // edits within the delete budget is guaranteed not to exceed
+    const size_t width = b.size() + 2;
+    const uint32_t infinity = static_cast<uint32_t>(a.size() + b.size());
+    buffer.resize((a.size() + 2) * width);
+    uint32_t *matrix = buffer.data();
+
+    // last row of a in which each character of b was seen
+    uint32_t lastRow[256];
+    for (char c : b)
+    {
+        lastRow[static_cast<uint8_t>(c)] = 0;
+    }
+    matrix[0] = infinity;
+    for (size_t i = 0; i <= a.size(); i++)
+    {
+        matrix[(i + 1) * width] = infinity;
+        matrix[(i + 1) * width + 1] = static_cast<uint32_t>(i);
+    }
+    for (size_t j = 0; j <= b.size(); j++)
+    {
+        matrix[j + 1] = infinity;
+        matrix[width + j + 1] = static_cast<uint32_t>(j);
+    }
+
+    for (size_t i = 1; i <= a.size(); i++)
+    {
+        uint32_t lastColumn = 0;
+        for (size_t j = 1; j <= b.size(); j++)
+        {
+            const uint32_t k = lastRow[static_cast<uint8_t>(b[j - 1])];
+            const uint32_t l = lastColumn;
+            uint32_t cost = 1;
+            if (a[i - 1] == b[j - 1])
+            {
+                cost = 0;
+                lastColumn = static_cast<uint32_t>(j);
+            }
+            const uint32_t substitution = matrix[i * width + j] + cost;
+            const uint32_t insertion = matrix[(i + 1) * width + j] + 1;
+            const uint32_t deletion = matrix[i * width + j + 1] + 1;
+            const uint32_t transposition = matrix[k * width + l] + static_cast<uint32_t>(i - k - 1) + 1 + static_cast<uint32_t>(j - l - 1);
+            matrix[(i + 1) * width + j + 1] = std::min(std::min(substitution, insertion), std::min(deletion, transposition));
+        }
+        lastRow[static_cast<uint8_t>(a[i - 1])] = static_cast<uint32_t>(i);
+    }
+    return matrix[(a.size() + 1) * width + b.size() + 1];
+}
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+FuzzyIndex::FuzzyIndex()
+    : _maxDistance(0), _prefixLength(0), _rowOffsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+FuzzyIndex::FuzzyIndex(const std::vector<std::string> &keys, const std::vector<size_t> &rows, size_t maxDistance, size_t prefixLength)
+    : _maxDistance(maxDistance), _prefixLength(std::max<size_t>(1, prefixLength))
+{
+    // group rows by normalized key
+    std::unordered_map<std::string, uint32_t> lookup;
+    std::vector<std::vector<uint32_t>> keyRows;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        std::string key = TrigramIndex::Normalize(keys[i]);
+        if (key.empty())
+        {
+            continue;
+        }
+
+        std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> inserted = lookup.emplace(key, static_cast<uint32_t>(_keys.size()));
+        if (inserted.second)
+        {
+            _keys.push_back(key);
+            keyRows.emplace_back();
+        }
+        keyRows[inserted.first->second].push_back(static_cast<uint32_t>(rows.empty() ? i : rows[i]));
+    }
+
+    _rowOffsets.reserve(_keys.size() + 1);
+    _rowOffsets.push_back(0);
+    for (const std::vector<uint32_t> &list : keyRows)
+    {
+        _rows.insert(_rows.end(), list.begin(), list.end());
+        _rowOffsets.push_back(static_cast<uint32_t>(_rows.size()));
+    }
+
+    // (hash, key << 8 | depth) entries sorted by hash
+    std::vector<std::pair<uint64_t, uint64_t>> entries;
+    std::vector<std::pair<uint64_t, uint32_t>> deletes;
+    for (uint32_t key = 0; key < _keys.size(); key++)
+    {
+        collectDeletes(_keys[key], _maxDistance, deletes);
+        for (const std::pair<uint64_t, uint32_t> &entry : deletes)
+        {
+            entries.emplace_back(entry.first, (static_cast<uint64_t>(key) << 8) | entry.second);
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    _deletes.reserve(entries.size());
+    _deleteKeys.reserve(entries.size());
+    _deleteDepths.reserve(entries.size());
+    for (const std::pair<uint64_t, uint64_t> &entry : entries)
+    {
+        _deletes.push_back(entry.first);
+        _deleteKeys.push_back(static_cast<uint32_t>(entry.second >> 8));
+        _deleteDepths.push_back(static_cast<uint8_t>(entry.second));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t FuzzyIndex::size() const
+{
+    return _keys.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t FuzzyIndex::getMaxDistance() const
+{
+    return _maxDistance;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t FuzzyIndex::getMemoryUsage() const
+{
+    size_t out = (_rowOffsets.capacity() + _rows.capacity() + _deleteKeys.capacity()) * sizeof(uint32_t) + _deletes.capacity() * sizeof(uint64_t) + _deleteDepths.capacity();
+    for (const std::string &key : _keys)
+    {
+        out += sizeof(std::string) + key.capacity();
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t FuzzyIndex::Distance(const std::string &a, const std::string &b)
+{
+    std::vector<uint32_t> buffer;
+    return Detail::DamerauLevenshtein(a, b, buffer);
+}
+
+// ----------------------------------------------------------------------------
+
+void FuzzyIndex::collectDeletes(const std::string &key, size_t maxDistance, std::vector<std::pair<uint64_t, uint32_t>> &out) const
+{
+    // breadth-first over deletion depth, deduplicating each level
+    std::vector<std::string> level(1, key.substr(0, _prefixLength));
+    std::vector<std::string> next;
+    out.clear();
+    out.emplace_back(Detail::HashDelete(level[0]), 0);
+    for (uint32_t depth = 1; depth <= maxDistance; depth++)
+    {
+        next.clear();
+        for (const std::string &text : level)
+        {
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                next.push_back(text.substr(0, i) + text.substr(i + 1));
+            }
+        }
+        std::sort(next.begin(), next.end());
+        next.erase(std::unique(next.begin(), next.end()), next.end());
+        for (const std::string &text : next)
+        {
+            out.emplace_back(Detail::HashDelete(text), depth);
+        }
+        level.swap(next);
+    }
+
+    // keep the shallowest depth of each delete
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end(), [](const std::pair<uint64_t, uint32_t> &a, const std::pair<uint64_t, uint32_t> &b)
+    {
+        return a.first == b.first;
+    }), out.end());
+}
+
+// ----------------------------------------------------------------------------
+
+void FuzzyIndex::collectMatches(const std::string &query, const std::vector<std::pair<uint64_t, uint32_t>> &deletes, size_t distance, std::vector<std::pair<uint32_t, uint32_t>> &out) const
+{
+    // keys within the distance share a delete reached with at most that many deletions on each side
+    std::vector<uint32_t> candidates;
+    for (const std::pair<uint64_t, uint32_t> &entry : deletes)
+    {
+        if (entry.second > distance)
+        {
+            continue;
+        }
+        const size_t begin = std::lower_bound(_deletes.begin(), _deletes.end(), entry.first) - _deletes.begin();
+        for (size_t i = begin; i < _deletes.size() && _deletes[i] == entry.first; i++)
+        {
+            if (_deleteDepths[i] <= distance)
+            {
+                candidates.push_back(_deleteKeys[i]);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    out.clear();
+    std::vector<uint32_t> buffer;
+    for (uint32_t key : candidates)
+    {
+        const std::string &text = _keys[key];
+        const size_t lengthDifference = text.size() > query.size() ? text.size() - query.size() : query.size() - text.size();
+        if (lengthDifference > distance)
+        {
+            continue;
+        }
+        const size_t value = Detail::DamerauLevenshtein(query, text, buffer);
+        if (value <= distance)
+        {
+            out.emplace_back(static_cast<uint32_t>(value), key);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<FuzzyMatch> FuzzyIndex::search(const std::string &query, size_t maxDistance, size_t limit) const
+{
+    std::vector<FuzzyMatch> out;
+    const std::string normalized = TrigramIndex::Normalize(query);
+    if (_keys.empty() || normalized.empty())
+    {
+        return out;
+    }
+    maxDistance = std::min(maxDistance, _maxDistance);
+
+    std::vector<std::pair<uint64_t, uint32_t>> deletes;
+    collectDeletes(normalized, maxDistance, deletes);
+
+    // widen the radius one edit at a time until enough rows are found, since
+    // the candidate count grows quickly with the radius for short identifiers
+    std::vector<std::pair<uint32_t, uint32_t>> matches; // (distance, key)
+    for (size_t distance = limit == 0 ? maxDistance : 0; distance <= maxDistance; distance++)
+    {
+        collectMatches(normalized, deletes, distance, matches);
+
+        size_t rows = 0;
+        for (const std::pair<uint32_t, uint32_t> &match : matches)
+        {
+            rows += _rowOffsets[match.second + 1] - _rowOffsets[match.second];
+        }
+        if (limit != 0 && rows >= limit)
+        {
+            break;
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [this](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b)
+    {
+        return a.first < b.first || (a.first == b.first && _keys[a.second] < _keys[b.second]);
+    });
+    for (const std::pair<uint32_t, uint32_t> &match : matches)
+    {
+        for (uint32_t i = _rowOffsets[match.second]; i < _rowOffsets[match.second + 1]; i++)
+        {
+            out.push_back({ _rows[i], match.first });
+        }
+        if (limit != 0 && out.size() >= limit)
+        {
+            out.resize(limit);
+            break;
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
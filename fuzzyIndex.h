@@ -0,0 +1,94 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+struct FuzzyMatch
+{
+    size_t row;
+    size_t distance; // edit distance between the query and the matched key
+};
+
+// ----------------------------------------------------------------------------
+
+// Symmetric delete (SymSpell) index over normalized keys (see
+// TrigramIndex::Normalize).  Every string reachable by deleting up to
+// maxDistance characters from the first prefixLength characters of a key is
+// hashed and stored; a query generates the same deletes of its own prefix and
+// only the keys sharing one of them are verified with the Damerau-Levenshtein
+// distance, so a transposition such as KSOF for KSFO counts as one edit.
+class FuzzyIndex
+{
+public:
+    FuzzyIndex();
+
+    // rows[i] is reported for keys[i]; when rows is empty the key's position is used
+    FuzzyIndex(const std::vector<std::string>& keys, const std::vector<size_t>& rows = std::vector<size_t>(), size_t maxDistance = 2, size_t prefixLength = 7);
+
+    size_t size() const;
+    size_t getMaxDistance() const;
+    size_t getMemoryUsage() const;
+
+    // rows whose key lies within maxDistance edits of the query (clamped to the distance the
+    // index was built for), nearest first and ties ordered by key; a limit of zero returns every match
+    std::vector<FuzzyMatch> search(const std::string& query, size_t maxDistance, size_t limit = 10) const;
+
+    static size_t Distance(const std::string& a, const std::string& b);
+
+private:
+    // (hash, number of deletions) of every delete of the key's prefix
+    void collectDeletes(const std::string& key, size_t maxDistance, std::vector<std::pair<uint64_t, uint32_t>>& out) const;
+    void collectMatches(const std::string& query, const std::vector<std::pair<uint64_t, uint32_t>>& deletes, size_t distance, std::vector<std::pair<uint32_t, uint32_t>>& out) const;
+
+private:
+    size_t _maxDistance;
+    size_t _prefixLength;
+    std::vector<std::string> _keys;     // unique normalized keys
+    std::vector<uint32_t> _rowOffsets;  // _keys.size() + 1 entries into _rows
+    std::vector<uint32_t> _rows;
+    std::vector<uint64_t> _deletes;     // sorted hashes of the deletes of every key
+    std::vector<uint32_t> _deleteKeys;  // key for each entry in _deletes
+    std::vector<uint8_t> _deleteDepths; // deletions that produced each entry in _deletes
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,228 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace NASR
+{
+
+namespace Geo
+{
+
+// ----------------------------------------------------------------------------
+
+double ToRadians(double degrees)
+{
+    return degrees * PI / 180.0;
+}
+
+// ----------------------------------------------------------------------------
+
+double ToDegrees(double radians)
+{
+    return radians * 180.0 / PI;
+}
+
+// ----------------------------------------------------------------------------
+
+double NormalizeLongitude(double longitude)
+{
+    while (longitude > 180.0)
+    {
+        longitude -= 360.0;
+    }
+    while (longitude < -180.0)
+    {
+        longitude += 360.0;
+    }
+    return longitude;
+}
+
+// ----------------------------------------------------------------------------
+
+bool BoundingBox::contains(double latitude, double longitude) const
+{
+    if (latitude < minLatitude || latitude > maxLatitude)
+    {
+        return false;
+    }
+    if (wrapsAntimeridian())
+    {
+        return longitude >= minLongitude || longitude <= maxLongitude;
+    }
+    return longitude >= minLongitude && longitude <= maxLongitude;
+}
+
+// ----------------------------------------------------------------------------
+
+bool BoundingBox::wrapsAntimeridian() const
+{
+    return minLongitude > maxLongitude;
+}
+
+// ----------------------------------------------------------------------------
+
+BoundingBox BoundingBox::expanded(double distance) const
+{
+    BoundingBox out = *this;
+    const double latitudeDelta = distance / 60.0;
+    out.minLatitude = std::max(-90.0, minLatitude - latitudeDelta);
+    out.maxLatitude = std::min(90.0, maxLatitude + latitudeDelta);
+
+    // longitude degrees shrink towards the poles, so widen using the most poleward latitude
+    const double extremeLatitude = std::max(std::abs(out.minLatitude), std::abs(out.maxLatitude));
+    const double cosine = std::cos(ToRadians(extremeLatitude));
+    const double span = wrapsAntimeridian() ? (maxLongitude + 360.0 - minLongitude) : (maxLongitude - minLongitude);
+    const double longitudeDelta = cosine > 1e-6 ? latitudeDelta / cosine : 360.0;
+
+    if (span + 2.0 * longitudeDelta >= 360.0)
+    {
+        out.minLongitude = -180.0;
+        out.maxLongitude = 180.0;
+        return out;
+    }
+
+    out.minLongitude = NormalizeLongitude(minLongitude - longitudeDelta);
+    out.maxLongitude = NormalizeLongitude(maxLongitude + longitudeDelta);
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+BoundingBox BoundingBox::Around(const Data::LatitudeLongitude &center, double radius)
+{
+    BoundingBox point{ center.getLatitude(), center.getLongitude(), center.getLatitude(), center.getLongitude() };
+    return point.expanded(radius);
+}
+
+// ----------------------------------------------------------------------------
+
+BoundingBox BoundingBox::Enclosing(const std::vector<Data::LatitudeLongitude> &points)
+{
+    // does not attempt to detect point sets that straddle the antimeridian
+    BoundingBox out{ 90.0, 180.0, -90.0, -180.0 };
+    for (const Data::LatitudeLongitude &point : points)
+    {
+        out.minLatitude = std::min(out.minLatitude, point.getLatitude());
+        out.maxLatitude = std::max(out.maxLatitude, point.getLatitude());
+        out.minLongitude = std::min(out.minLongitude, point.getLongitude());
+        out.maxLongitude = std::max(out.maxLongitude, point.getLongitude());
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+double Distance(double latitudeA, double longitudeA, double latitudeB, double longitudeB)
+{
+    // haversine
+    const double phiA = ToRadians(latitudeA);
+    const double phiB = ToRadians(latitudeB);
+    const double sinHalfPhi = std::sin((phiB - phiA) / 2.0);
+    const double sinHalfLambda = std::sin(ToRadians(longitudeB - longitudeA) / 2.0);
+    const double h = sinHalfPhi * sinHalfPhi + std::cos(phiA) * std::cos(phiB) * sinHalfLambda * sinHalfLambda;
+    return 2.0 * EARTH_RADIUS_NM * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+// ----------------------------------------------------------------------------
+
+double Distance(const Data::LatitudeLongitude &a, const Data::LatitudeLongitude &b)
+{
+    return Distance(a.getLatitude(), a.getLongitude(), b.getLatitude(), b.getLongitude());
+}
+
+// ----------------------------------------------------------------------------
+
+double InitialBearing(const Data::LatitudeLongitude &from, const Data::LatitudeLongitude &to)
+{
+    const double phiA = ToRadians(from.getLatitude());
+    const double phiB = ToRadians(to.getLatitude());
+    const double deltaLambda = ToRadians(to.getLongitude() - from.getLongitude());
+    const double y = std::sin(deltaLambda) * std::cos(phiB);
+    const double x = std::cos(phiA) * std::sin(phiB) - std::sin(phiA) * std::cos(phiB) * std::cos(deltaLambda);
+    return std::fmod(ToDegrees(std::atan2(y, x)) + 360.0, 360.0);
+}
+
+// ----------------------------------------------------------------------------
+
+Data::LatitudeLongitude Intermediate(const Data::LatitudeLongitude &from, const Data::LatitudeLongitude &to, double fraction)
+{
+    const double delta = Distance(from, to) / EARTH_RADIUS_NM;
+    if (delta < 1e-12)
+    {
+        return from;
+    }
+
+    const double phiA = ToRadians(from.getLatitude());
+    const double lambdaA = ToRadians(from.getLongitude());
+    const double phiB = ToRadians(to.getLatitude());
+    const double lambdaB = ToRadians(to.getLongitude());
+
+    const double a = std::sin((1.0 - fraction) * delta) / std::sin(delta);
+    const double b = std::sin(fraction * delta) / std::sin(delta);
+    const double x = a * std::cos(phiA) * std::cos(lambdaA) + b * std::cos(phiB) * std::cos(lambdaB);
+    const double y = a * std::cos(phiA) * std::sin(lambdaA) + b * std::cos(phiB) * std::sin(lambdaB);
+    const double z = a * std::sin(phiA) + b * std::sin(phiB);
+
+    return Data::LatitudeLongitude(ToDegrees(std::atan2(z, std::sqrt(x * x + y * y))), ToDegrees(std::atan2(y, x)));
+}
+
+// ----------------------------------------------------------------------------
+
+double CrossTrackDistance(const Data::LatitudeLongitude &point, const Data::LatitudeLongitude &start, const Data::LatitudeLongitude &end)
+{
+    const double delta13 = Distance(start, point) / EARTH_RADIUS_NM;
+    const double theta13 = ToRadians(InitialBearing(start, point));
+    const double theta12 = ToRadians(InitialBearing(start, end));
+    return std::asin(std::sin(delta13) * std::sin(theta13 - theta12)) * EARTH_RADIUS_NM;
+}
+
+// ----------------------------------------------------------------------------
+
+double AlongTrackDistance(const Data::LatitudeLongitude &point, const Data::LatitudeLongitude &start, const Data::LatitudeLongitude &end)
+{
+    const double delta13 = Distance(start, point) / EARTH_RADIUS_NM;
+    const double theta13 = ToRadians(InitialBearing(start, point));
+    const double theta12 = ToRadians(InitialBearing(start, end));
+    const double deltaXt = std::asin(std::sin(delta13) * std::sin(theta13 - theta12));
+    const double ratio = std::max(-1.0, std::min(1.0, std::cos(delta13) / std::cos(deltaXt)));
+    const double sign = std::cos(theta13 - theta12) < 0.0 ? -1.0 : 1.0;
+    return sign * std::acos(ratio) * EARTH_RADIUS_NM;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Geo
+
+} // namespace NASR
@@ -0,0 +1,93 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "data.h"
+
+#include <vector>
+
+namespace NASR
+{
+
+namespace Geo
+{
+
+// ----------------------------------------------------------------------------
+
+// all distances are in nautical miles, all angles are in degrees
+constexpr double EARTH_RADIUS_NM = 3440.065;
+constexpr double FEET_PER_NM = 6076.12;
+constexpr double PI = 3.14159265358979323846;
+
+// ----------------------------------------------------------------------------
+
+double ToRadians(double degrees);
+double ToDegrees(double radians);
+double NormalizeLongitude(double longitude);
+
+// ----------------------------------------------------------------------------
+
+// an axis-aligned latitude/longitude box; minLongitude > maxLongitude means
+// the box wraps across the antimeridian
+struct BoundingBox
+{
+    double minLatitude;
+    double minLongitude;
+    double maxLatitude;
+    double maxLongitude;
+
+    bool contains(double latitude, double longitude) const;
+    bool wrapsAntimeridian() const;
+    BoundingBox expanded(double distance) const;
+
+    static BoundingBox Around(const Data::LatitudeLongitude& center, double radius);
+    static BoundingBox Enclosing(const std::vector<Data::LatitudeLongitude>& points);
+};
+
+// ----------------------------------------------------------------------------
+
+double Distance(double latitudeA, double longitudeA, double latitudeB, double longitudeB);
+double Distance(const Data::LatitudeLongitude& a, const Data::LatitudeLongitude& b);
+double InitialBearing(const Data::LatitudeLongitude& from, const Data::LatitudeLongitude& to);
+Data::LatitudeLongitude Intermediate(const Data::LatitudeLongitude& from, const Data::LatitudeLongitude& to, double fraction);
+
+// signed distance from the great circle through start and end (positive to the right)
+double CrossTrackDistance(const Data::LatitudeLongitude& point, const Data::LatitudeLongitude& start, const Data::LatitudeLongitude& end);
+
+// distance from start to the foot of the perpendicular from point onto the great circle
+double AlongTrackDistance(const Data::LatitudeLongitude& point, const Data::LatitudeLongitude& start, const Data::LatitudeLongitude& end);
+
+// ----------------------------------------------------------------------------
+
+} // namespace Geo
+
+} // namespace NASR
@@ -0,0 +1,295 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "hashJoin.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+struct JoinEntry
+{
+    uint64_t hash;
+    uint32_t row;
+};
+
+// ----------------------------------------------------------------------------
+
+// the key columns of one side of a join, hashed and scattered into partitions
+struct JoinSide
+{
+    std::vector<std::vector<std::string>> columns;
+    std::vector<JoinEntry> entries;             // grouped by partition
+    std::vector<size_t> partitionOffsets;       // partitions + 1 entries into entries
+};
+
+// ----------------------------------------------------------------------------
+
+uint64_t HashKey(const std::vector<std::vector<std::string>> &columns, size_t row)
+{
+    // FNV-1a over the values with a separator between columns
+    uint64_t hash = 14695981039346656037ull;
+    for (const std::vector<std::string> &column : columns)
+    {
+        for (unsigned char c : column[row])
+        {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0x1F) * 1099511628211ull;
+    }
+    // FNV leaves the high bits poorly mixed, and they select the partition
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+
+bool KeysEqual(const JoinSide &left, size_t leftRow, const JoinSide &right, size_t rightRow)
+{
+    for (size_t column = 0; column < left.columns.size(); column++)
+    {
+        if (left.columns[column][leftRow] != right.columns[column][rightRow])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+JoinSide PartitionSide(const CSV::File &file, const std::vector<std::string> &columns, size_t partitionBits, size_t threads)
+{
+    JoinSide side;
+    for (const std::string &name : columns)
+    {
+        side.columns.push_back(file.getColumn(name).get());
+    }
+    const size_t rowCount = side.columns.empty() ? 0 : side.columns[0].size();
+    const size_t partitions = size_t(1) << partitionBits;
+    const size_t shift = 64 - partitionBits;
+
+    // hash, then count per thread and partition so every thread scatters into its own ranges
+    std::vector<JoinEntry> hashed(rowCount);
+    std::vector<uint8_t> usable(rowCount, 0);
+    std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(partitions, 0));
+    Parallel::For(rowCount, threads, [&](size_t begin, size_t end, size_t thread)
+    {
+        for (size_t row = begin; row < end; row++)
+        {
+            bool empty = false;
+            for (const std::vector<std::string> &column : side.columns)
+            {
+                empty |= column[row].empty();
+            }
+            if (empty)
+            {
+                continue;
+            }
+            hashed[row] = { HashKey(side.columns, row), static_cast<uint32_t>(row) };
+            usable[row] = 1;
+            counts[thread][partitionBits == 0 ? 0 : hashed[row].hash >> shift]++;
+        }
+    });
+
+    side.partitionOffsets.assign(partitions + 1, 0);
+    std::vector<std::vector<size_t>> cursors(threads, std::vector<size_t>(partitions, 0));
+    size_t offset = 0;
+    for (size_t partition = 0; partition < partitions; partition++)
+    {
+        side.partitionOffsets[partition] = offset;
+        for (size_t thread = 0; thread < threads; thread++)
+        {
+            cursors[thread][partition] = offset;
+            offset += counts[thread][partition];
+        }
+    }
+    side.partitionOffsets[partitions] = offset;
+
+    side.entries.resize(offset);
+    Parallel::For(rowCount, threads, [&](size_t begin, size_t end, size_t thread)
+    {
+        for (size_t row = begin; row < end; row++)
+        {
+            if (usable[row])
+            {
+                side.entries[cursors[thread][partitionBits == 0 ? 0 : hashed[row].hash >> shift]++] = hashed[row];
+            }
+        }
+    });
+    return side;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+std::vector<RowPair> HashJoin(const CSV::File &left, const std::vector<std::string> &leftColumns, const CSV::File &right, const std::vector<std::string> &rightColumns, size_t threads)
+{
+    if (leftColumns.size() != rightColumns.size() || leftColumns.empty())
+    {
+        throw std::invalid_argument("join keys must name the same, non-zero number of columns on both sides");
+    }
+    if (!left.isValid() || !right.isValid())
+    {
+        return std::vector<RowPair>();
+    }
+
+    // about 4096 left rows per partition, and enough partitions to keep every thread busy
+    threads = Parallel::GetThreadCount(threads);
+    const size_t leftRows = left.getColumn(leftColumns[0]).get().size();
+    size_t partitionBits = 0;
+    while (partitionBits < 10 && ((size_t(1) << partitionBits) < threads * 4 || (leftRows >> partitionBits) > 4096))
+    {
+        partitionBits++;
+    }
+
+    const Detail::JoinSide build = Detail::PartitionSide(left, leftColumns, partitionBits, threads);
+    const Detail::JoinSide probe = Detail::PartitionSide(right, rightColumns, partitionBits, threads);
+
+    const size_t partitions = size_t(1) << partitionBits;
+    std::vector<std::vector<RowPair>> partial(threads);
+    Parallel::For(partitions, threads, [&](size_t begin, size_t end, size_t thread)
+    {
+        std::vector<uint32_t> slots;
+        for (size_t partition = begin; partition < end; partition++)
+        {
+            const size_t buildBegin = build.partitionOffsets[partition];
+            const size_t buildEnd = build.partitionOffsets[partition + 1];
+            if (buildBegin == buildEnd)
+            {
+                continue;
+            }
+
+            // open addressing over the build entries, which may repeat a key
+            size_t slotCount = 16;
+            while (slotCount < (buildEnd - buildBegin) * 2)
+            {
+                slotCount *= 2;
+            }
+            const size_t mask = slotCount - 1;
+            slots.assign(slotCount, 0);
+            for (size_t entry = buildBegin; entry < buildEnd; entry++)
+            {
+                size_t slot = build.entries[entry].hash & mask;
+                while (slots[slot] != 0)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                slots[slot] = static_cast<uint32_t>(entry - buildBegin + 1);
+            }
+
+            for (size_t entry = probe.partitionOffsets[partition]; entry < probe.partitionOffsets[partition + 1]; entry++)
+            {
+                const Detail::JoinEntry &probeEntry = probe.entries[entry];
+                for (size_t slot = probeEntry.hash & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+                {
+                    const Detail::JoinEntry &buildEntry = build.entries[buildBegin + slots[slot] - 1];
+                    if (buildEntry.hash == probeEntry.hash && Detail::KeysEqual(build, buildEntry.row, probe, probeEntry.row))
+                    {
+                        partial[thread].push_back({ buildEntry.row, probeEntry.row });
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<RowPair> out;
+    for (const std::vector<RowPair> &pairs : partial)
+    {
+        out.insert(out.end(), pairs.begin(), pairs.end());
+    }
+    std::sort(out.begin(), out.end(), [](const RowPair &a, const RowPair &b)
+    {
+        return a.left < b.left || (a.left == b.left && a.right < b.right);
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+JoinedView::JoinedView(const CSV::File &left, const CSV::File &right, std::vector<RowPair> pairs)
+    : _left(&left), _right(&right), _pairs(std::move(pairs))
+{
+}
+
+// ----------------------------------------------------------------------------
+
+size_t JoinedView::size() const
+{
+    return _pairs.size();
+}
+
+// ----------------------------------------------------------------------------
+
+const RowPair &JoinedView::operator[](size_t index) const
+{
+    return _pairs[index];
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<RowPair> &JoinedView::getPairs() const
+{
+    return _pairs;
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::Row JoinedView::getLeftRow(size_t index) const
+{
+    return _left->getRow(_pairs[index].left);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::Row JoinedView::getRightRow(size_t index) const
+{
+    return _right->getRow(_pairs[index].right);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
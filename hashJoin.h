@@ -0,0 +1,84 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+struct RowPair
+{
+    uint32_t left;
+    uint32_t right;
+};
+
+// ----------------------------------------------------------------------------
+
+// Equi-join of two files on declared key columns, e.g. APT_RWY_END with
+// APT_ARS on (ARPT_ID, RWY_ID, RWY_END_ID).  Both sides are hashed and
+// radix-partitioned on the hash in parallel, then each partition builds a
+// hash table over its left rows and probes it with its right rows on its
+// own thread.  Rows with an empty key value never match.  Pairs come back
+// sorted by left row, then right row.
+std::vector<RowPair> HashJoin(const CSV::File& left, const std::vector<std::string>& leftColumns, const CSV::File& right, const std::vector<std::string>& rightColumns, size_t threads = 0);
+
+// ----------------------------------------------------------------------------
+
+// the pairs of a HashJoin together with the files they index, which must outlive the view
+class JoinedView
+{
+public:
+    JoinedView(const CSV::File& left, const CSV::File& right, std::vector<RowPair> pairs);
+
+    size_t size() const;
+    const RowPair& operator[](size_t index) const;
+    const std::vector<RowPair>& getPairs() const;
+
+    CSV::Row getLeftRow(size_t index) const;
+    CSV::Row getRightRow(size_t index) const;
+
+private:
+    const CSV::File* _left;
+    const CSV::File* _right;
+    std::vector<RowPair> _pairs;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,147 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "identifierIndex.h"
+
+#include <algorithm>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+IdentifierIndex::IdentifierIndex()
+{
+}
+
+// ----------------------------------------------------------------------------
+
+IdentifierIndex::IdentifierIndex(const std::vector<std::string> &identifiers)
+{
+    std::vector<uint32_t> order;
+    order.reserve(identifiers.size());
+    for (size_t row = 0; row < identifiers.size(); row++)
+    {
+        if (!identifiers[row].empty())
+        {
+            order.push_back(static_cast<uint32_t>(row));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&identifiers](uint32_t a, uint32_t b)
+    {
+        return identifiers[a] < identifiers[b];
+    });
+
+    _keys.reserve(order.size());
+    _rows.reserve(order.size());
+    for (uint32_t row : order)
+    {
+        _keys.push_back(identifiers[row]);
+        _rows.push_back(row);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t IdentifierIndex::size() const
+{
+    return _keys.size();
+}
+
+// ----------------------------------------------------------------------------
+
+bool IdentifierIndex::empty() const
+{
+    return _keys.empty();
+}
+
+// ----------------------------------------------------------------------------
+
+const std::string &IdentifierIndex::getKey(size_t position) const
+{
+    return _keys[position];
+}
+
+// ----------------------------------------------------------------------------
+
+size_t IdentifierIndex::getRow(size_t position) const
+{
+    return _rows[position];
+}
+
+// ----------------------------------------------------------------------------
+
+IdentifierRange IdentifierIndex::find(const std::string &identifier) const
+{
+    std::pair<std::vector<std::string>::const_iterator, std::vector<std::string>::const_iterator> range = std::equal_range(_keys.begin(), _keys.end(), identifier);
+    return { static_cast<size_t>(range.first - _keys.begin()), static_cast<size_t>(range.second - _keys.begin()) };
+}
+
+// ----------------------------------------------------------------------------
+
+IdentifierRange IdentifierIndex::findPrefix(const std::string &prefix) const
+{
+    // keys starting with the prefix compare equal to it on their first prefix.size() characters
+    std::vector<std::string>::const_iterator begin = std::lower_bound(_keys.begin(), _keys.end(), prefix, [](const std::string &key, const std::string &value)
+    {
+        return key.compare(0, value.size(), value) < 0;
+    });
+    std::vector<std::string>::const_iterator end = std::upper_bound(begin, _keys.end(), prefix, [](const std::string &value, const std::string &key)
+    {
+        return key.compare(0, value.size(), value) > 0;
+    });
+    return { static_cast<size_t>(begin - _keys.begin()), static_cast<size_t>(end - _keys.begin()) };
+}
+
+// ----------------------------------------------------------------------------
+
+IdentifierRange IdentifierIndex::findRange(const std::string &low, const std::string &high) const
+{
+    std::vector<std::string>::const_iterator begin = std::lower_bound(_keys.begin(), _keys.end(), low);
+    std::vector<std::string>::const_iterator end = std::lower_bound(begin, _keys.end(), high);
+    return { static_cast<size_t>(begin - _keys.begin()), static_cast<size_t>(end - _keys.begin()) };
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<size_t> IdentifierIndex::findRow(const std::string &identifier) const
+{
+    const IdentifierRange range = find(identifier);
+    if (range.size() != 1)
+    {
+        return tl::nullopt;
+    }
+    return getRow(range.begin);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,94 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional.hpp>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// half-open range of positions within an IdentifierIndex
+struct IdentifierRange
+{
+    size_t begin;
+    size_t end;
+
+    size_t size() const { return end - begin; }
+    bool empty() const { return begin == end; }
+};
+
+// ----------------------------------------------------------------------------
+
+// Identifiers sorted lexicographically alongside the row each came from.
+// Exact, prefix and range lookups are binary searches that return a range of
+// positions, so queries do not allocate.  Empty identifiers are not indexed.
+class IdentifierIndex
+{
+public:
+    IdentifierIndex();
+    IdentifierIndex(const std::vector<std::string>& identifiers);
+
+    size_t size() const;
+    bool empty() const;
+    const std::string& getKey(size_t position) const;
+    size_t getRow(size_t position) const;
+
+    IdentifierRange find(const std::string& identifier) const;
+    IdentifierRange findPrefix(const std::string& prefix) const;
+    IdentifierRange findRange(const std::string& low, const std::string& high) const; // low inclusive, high exclusive
+
+    // the row of the identifier when it occurs exactly once
+    tl::optional<size_t> findRow(const std::string& identifier) const;
+
+    template <typename Callback>
+    void forEachWithPrefix(const std::string& prefix, Callback callback) const
+    {
+        const IdentifierRange range = findPrefix(prefix);
+        for (size_t position = range.begin; position < range.end; position++)
+        {
+            callback(_keys[position], static_cast<size_t>(_rows[position]));
+        }
+    }
+
+private:
+    std::vector<std::string> _keys;
+    std::vector<uint32_t> _rows;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
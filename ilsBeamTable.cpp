@@ -0,0 +1,376 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ilsBeamTable.h"
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr uint8_t ILSBeamTable::LOCALIZER;
+constexpr uint8_t ILSBeamTable::GLIDESLOPE;
+constexpr double ILSBeamTable::LOCALIZER_RANGE;
+constexpr double ILSBeamTable::LOCALIZER_WIDE_RANGE;
+constexpr double ILSBeamTable::GLIDESLOPE_RANGE;
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+// nominal localizer sector when neither width is published
+constexpr double DEFAULT_HALF_WIDTH = 2.5;
+
+// ----------------------------------------------------------------------------
+
+struct LocalOffset
+{
+    double east;
+    double north;
+    double up;
+};
+
+// ----------------------------------------------------------------------------
+
+tl::optional<double> ParseCell(const std::vector<std::string> &values, size_t row)
+{
+    if (row >= values.size())
+    {
+        return tl::nullopt;
+    }
+    return CSV::Utils::ParseOptional<double>(values[row]);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::string> GetValues(const CSV::File &file, const std::string &column)
+{
+    return file.isValid() ? file.getColumn(column).get() : std::vector<std::string>();
+}
+
+// ----------------------------------------------------------------------------
+
+// along-course distance (positive in front of the antenna, on the approach side) and
+// cross-course distance (positive right of the inbound course)
+void CourseComponents(const LocalOffset &offset, double sinCourse, double cosCourse, double &along, double &cross)
+{
+    along = -(offset.east * sinCourse + offset.north * cosCourse);
+    cross = offset.east * cosCourse - offset.north * sinCourse;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+ILSBeamTable::ILSBeamTable()
+{
+}
+
+// ----------------------------------------------------------------------------
+
+ILSBeamTable::ILSBeamTable(const ILSSystemTable &systems, const CSV::File &ilsBase, const CSV::File &glideslope, const CSV::File &runwayEnds)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const size_t count = systems.size();
+    _localizers.resize(count);
+    _glideslopes.resize(count);
+    _sinCourse.assign(count, 0.0);
+    _cosCourse.assign(count, 1.0);
+    _course.assign(count, nan);
+    _halfWidth.assign(count, static_cast<float>(Geo::ToRadians(Detail::DEFAULT_HALF_WIDTH)));
+    _glideslopeAngle.assign(count, nan);
+    _hasLocalizer.assign(count, 0);
+    if (count == 0 || !ilsBase.isValid())
+    {
+        return;
+    }
+
+    const std::vector<std::string> latitudes = ilsBase.getColumn("LAT_DECIMAL").get();
+    const std::vector<std::string> longitudes = ilsBase.getColumn("LONG_DECIMAL").get();
+    const std::vector<std::string> elevations = ilsBase.getColumn("SITE_ELEVATION").get();
+    const std::vector<std::string> bearings = ilsBase.getColumn("APCH_BEAR").get();
+    const std::vector<std::string> variations = ilsBase.getColumn("MAG_VAR").get();
+    const std::vector<std::string> hemispheres = ilsBase.getColumn("MAG_VAR_HEMIS").get();
+    const std::vector<std::string> widths = ilsBase.getColumn("CRS_WIDTH").get();
+    const std::vector<std::string> thresholdWidths = ilsBase.getColumn("CRS_WIDTH_AT_THRESH").get();
+    const std::vector<std::string> thresholdLatitudes = Detail::GetValues(runwayEnds, "LAT_DECIMAL");
+    const std::vector<std::string> thresholdLongitudes = Detail::GetValues(runwayEnds, "LONG_DECIMAL");
+    const std::vector<std::string> glideslopeLatitudes = Detail::GetValues(glideslope, "LAT_DECIMAL");
+    const std::vector<std::string> glideslopeLongitudes = Detail::GetValues(glideslope, "LONG_DECIMAL");
+    const std::vector<std::string> glideslopeElevations = Detail::GetValues(glideslope, "SITE_ELEVATION");
+    const std::vector<std::string> glideslopeAngles = Detail::GetValues(glideslope, "G_S_ANGLE");
+    std::vector<Data::LatitudeLongitude> positions(count);
+    for (size_t system = 0; system < count; system++)
+    {
+        const ILSSystem &entry = systems.getSystem(system);
+        const uint32_t row = entry.localizerRow;
+        const tl::optional<double> latitude = Detail::ParseCell(latitudes, row);
+        const tl::optional<double> longitude = Detail::ParseCell(longitudes, row);
+        const tl::optional<double> bearing = Detail::ParseCell(bearings, row);
+        if (!latitude || !longitude || !bearing)
+        {
+            continue;
+        }
+
+        const tl::optional<double> variation = Detail::ParseCell(variations, row);
+        const double east = variation ? (hemispheres[row] == "W" ? -*variation : *variation) : 0.0;
+        const double course = std::fmod(*bearing + east + 360.0, 360.0);
+        const tl::optional<double> elevation = Detail::ParseCell(elevations, row);
+        _localizers[system] = MakeFrame(*latitude, *longitude, elevation ? *elevation : 0.0);
+        _sinCourse[system] = std::sin(Geo::ToRadians(course));
+        _cosCourse[system] = std::cos(Geo::ToRadians(course));
+        _course[system] = static_cast<float>(course);
+        _hasLocalizer[system] = 1;
+        positions[system] = Data::LatitudeLongitude(*latitude, *longitude);
+
+        // the published sector width, else the width at the threshold seen from the antenna
+        const tl::optional<double> width = Detail::ParseCell(widths, row);
+        const tl::optional<double> thresholdWidth = Detail::ParseCell(thresholdWidths, row);
+        if (width && *width > 0.0)
+        {
+            _halfWidth[system] = static_cast<float>(Geo::ToRadians(*width / 2.0));
+        }
+        else if (thresholdWidth && *thresholdWidth > 0.0)
+        {
+            const tl::optional<double> thresholdLatitude = Detail::ParseCell(thresholdLatitudes, entry.runwayEndRow);
+            const tl::optional<double> thresholdLongitude = Detail::ParseCell(thresholdLongitudes, entry.runwayEndRow);
+            const double distance = thresholdLatitude && thresholdLongitude ? Geo::Distance(*latitude, *longitude, *thresholdLatitude, *thresholdLongitude) : 0.0;
+            if (distance > 0.0)
+            {
+                _halfWidth[system] = static_cast<float>(std::atan(*thresholdWidth / 2.0 / (distance * Geo::FEET_PER_NM)));
+            }
+        }
+
+        // NO_ROW is past the end of every column, so absent glideslopes parse as missing
+        const tl::optional<double> glideslopeLatitude = Detail::ParseCell(glideslopeLatitudes, entry.glideslopeRow);
+        const tl::optional<double> glideslopeLongitude = Detail::ParseCell(glideslopeLongitudes, entry.glideslopeRow);
+        const tl::optional<double> glideslopeElevation = Detail::ParseCell(glideslopeElevations, entry.glideslopeRow);
+        const tl::optional<double> angle = Detail::ParseCell(glideslopeAngles, entry.glideslopeRow);
+        if (glideslopeLatitude && glideslopeLongitude && angle && *angle > 0.0)
+        {
+            _glideslopes[system] = MakeFrame(*glideslopeLatitude, *glideslopeLongitude, glideslopeElevation ? *glideslopeElevation : 0.0);
+            _glideslopeAngle[system] = static_cast<float>(Geo::ToRadians(*angle));
+        }
+    }
+    _index = SpatialIndex(positions);
+}
+
+// ----------------------------------------------------------------------------
+
+ILSBeamTable::Frame ILSBeamTable::MakeFrame(double latitude, double longitude, double elevation)
+{
+    const double radius = Geo::EARTH_RADIUS_NM + elevation / Geo::FEET_PER_NM;
+    Frame frame;
+    frame.sinLatitude = std::sin(Geo::ToRadians(latitude));
+    frame.cosLatitude = std::cos(Geo::ToRadians(latitude));
+    frame.sinLongitude = std::sin(Geo::ToRadians(longitude));
+    frame.cosLongitude = std::cos(Geo::ToRadians(longitude));
+    frame.x = radius * frame.cosLatitude * frame.cosLongitude;
+    frame.y = radius * frame.cosLatitude * frame.sinLongitude;
+    frame.z = radius * frame.sinLatitude;
+    return frame;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t ILSBeamTable::size() const
+{
+    return _course.size();
+}
+
+// ----------------------------------------------------------------------------
+
+bool ILSBeamTable::hasLocalizer(size_t system) const
+{
+    return _hasLocalizer[system] != 0;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ILSBeamTable::hasGlideslope(size_t system) const
+{
+    return !std::isnan(_glideslopeAngle[system]);
+}
+
+// ----------------------------------------------------------------------------
+
+float ILSBeamTable::getCourse(size_t system) const
+{
+    return _course[system];
+}
+
+// ----------------------------------------------------------------------------
+
+float ILSBeamTable::getHalfWidth(size_t system) const
+{
+    return static_cast<float>(Geo::ToDegrees(_halfWidth[system]));
+}
+
+// ----------------------------------------------------------------------------
+
+float ILSBeamTable::getGlideslopeAngle(size_t system) const
+{
+    return static_cast<float>(Geo::ToDegrees(_glideslopeAngle[system]));
+}
+
+// ----------------------------------------------------------------------------
+
+ILSDeviation ILSBeamTable::evaluate(size_t system, double x, double y, double z) const
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    ILSDeviation out = { 0, system, nan, nan, nan, 0 };
+    if (!_hasLocalizer[system])
+    {
+        return out;
+    }
+
+    const Frame &localizer = _localizers[system];
+    const double sinCourse = _sinCourse[system];
+    const double cosCourse = _cosCourse[system];
+    const double dx = x - localizer.x;
+    const double dy = y - localizer.y;
+    const double dz = z - localizer.z;
+    const Detail::LocalOffset offset = {
+        -localizer.sinLongitude * dx + localizer.cosLongitude * dy,
+        -localizer.sinLatitude * localizer.cosLongitude * dx - localizer.sinLatitude * localizer.sinLongitude * dy + localizer.cosLatitude * dz,
+        localizer.cosLatitude * localizer.cosLongitude * dx + localizer.cosLatitude * localizer.sinLongitude * dy + localizer.sinLatitude * dz
+    };
+    double along;
+    double cross;
+    Detail::CourseComponents(offset, sinCourse, cosCourse, along, cross);
+
+    const double distance = std::sqrt(offset.east * offset.east + offset.north * offset.north);
+    const double bearing = std::atan2(cross, along);    // off the course, zero on the approach side
+    const double azimuth = std::fabs(bearing);
+    out.distance = static_cast<float>(distance);
+    out.lateral = static_cast<float>(bearing / _halfWidth[system]);
+    if ((azimuth <= Geo::ToRadians(10.0) && distance <= LOCALIZER_RANGE) || (azimuth <= Geo::ToRadians(35.0) && distance <= LOCALIZER_WIDE_RANGE))
+    {
+        out.reception |= LOCALIZER;
+    }
+
+    const double angle = _glideslopeAngle[system];
+    if (std::isnan(angle))
+    {
+        return out;
+    }
+
+    const Frame &glideslope = _glideslopes[system];
+    const double gx = x - glideslope.x;
+    const double gy = y - glideslope.y;
+    const double gz = z - glideslope.z;
+    const Detail::LocalOffset glideslopeOffset = {
+        -glideslope.sinLongitude * gx + glideslope.cosLongitude * gy,
+        -glideslope.sinLatitude * glideslope.cosLongitude * gx - glideslope.sinLatitude * glideslope.sinLongitude * gy + glideslope.cosLatitude * gz,
+        glideslope.cosLatitude * glideslope.cosLongitude * gx + glideslope.cosLatitude * glideslope.sinLongitude * gy + glideslope.sinLatitude * gz
+    };
+    Detail::CourseComponents(glideslopeOffset, sinCourse, cosCourse, along, cross);
+
+    const double horizontal = std::sqrt(glideslopeOffset.east * glideslopeOffset.east + glideslopeOffset.north * glideslopeOffset.north);
+    const double elevation = std::atan2(glideslopeOffset.up, horizontal);
+    out.vertical = static_cast<float>((elevation - angle) / (0.24 * angle));
+    if (along > 0.0 && std::fabs(std::atan2(cross, along)) <= Geo::ToRadians(8.0) && horizontal <= GLIDESLOPE_RANGE &&
+        elevation >= 0.45 * angle && elevation <= 1.75 * angle)
+    {
+        out.reception |= GLIDESLOPE;
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+ILSDeviation ILSBeamTable::computeDeviation(size_t system, const Data::LatitudeLongitude &position, double altitude) const
+{
+    const Frame aircraft = MakeFrame(position.getLatitude(), position.getLongitude(), altitude);
+    return evaluate(system, aircraft.x, aircraft.y, aircraft.z);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<ILSDeviation> ILSBeamTable::computeDeviations(const std::vector<Data::LatitudeLongitude> &positions, const std::vector<double> &altitudes, size_t threads) const
+{
+    const size_t count = std::min(positions.size(), altitudes.size());
+    std::vector<std::vector<ILSDeviation>> partials(Parallel::GetThreadCount(threads));
+    Parallel::For(count, partials.size(), [&](size_t begin, size_t end, size_t thread)
+    {
+        std::vector<ILSDeviation> &local = partials[thread];
+        std::vector<size_t> candidates;
+        for (size_t aircraft = begin; aircraft < end; aircraft++)
+        {
+            const Data::LatitudeLongitude &position = positions[aircraft];
+            if (!position.valid())
+            {
+                continue;
+            }
+
+            // each aircraft is converted once, then rotated into the frame of each nearby antenna
+            candidates.clear();
+            _index.forEachInBoundingBox(Geo::BoundingBox::Around(position, LOCALIZER_RANGE), [&](size_t system)
+            {
+                candidates.push_back(system);
+            });
+            std::sort(candidates.begin(), candidates.end());
+
+            const Frame frame = MakeFrame(position.getLatitude(), position.getLongitude(), altitudes[aircraft]);
+            for (size_t system : candidates)
+            {
+                ILSDeviation deviation = evaluate(system, frame.x, frame.y, frame.z);
+                if (deviation.distance <= LOCALIZER_RANGE)
+                {
+                    deviation.aircraft = aircraft;
+                    local.push_back(deviation);
+                }
+            }
+        }
+    });
+
+    std::vector<ILSDeviation> out;
+    for (const std::vector<ILSDeviation> &local : partials)
+    {
+        out.insert(out.end(), local.begin(), local.end());
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,122 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+#include "data.h"
+#include "ilsSystemTable.h"
+#include "spatialIndex.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+struct ILSDeviation
+{
+    size_t aircraft;    // index into the positions
+    size_t system;      // ILSSystemTable index
+    float distance;     // nautical miles from the localizer antenna, horizontally
+    float lateral;      // full-scale deflections, positive when right of the inbound course
+    float vertical;     // full-scale deflections, positive when above the path; NaN without a glideslope
+    uint8_t reception;  // ILSBeamTable::LOCALIZER and GLIDESLOPE when receivable
+};
+
+// ----------------------------------------------------------------------------
+
+// Localizer and glideslope geometry of every ILS system, indexed like the
+// ILSSystemTable.  Each antenna is stored as an Earth-centered position with
+// the rotation into its local east/north/up frame, so a deviation is one
+// subtraction and one rotation per antenna.  The inbound course is APCH_BEAR
+// corrected by MAG_VAR; the sector half width is half of CRS_WIDTH, or else
+// derived from CRS_WIDTH_AT_THRESH and the distance to the runway threshold,
+// or else 2.5 degrees.  Full-scale glideslope deflection is 0.24 times the
+// glideslope angle.  Reception follows the ICAO coverage: the localizer within
+// 10 degrees of course to LOCALIZER_RANGE and 35 degrees to
+// LOCALIZER_WIDE_RANGE, the glideslope within 8 degrees of course to
+// GLIDESLOPE_RANGE and between 0.45 and 1.75 times its angle.
+class ILSBeamTable
+{
+public:
+    static constexpr uint8_t LOCALIZER = 1;
+    static constexpr uint8_t GLIDESLOPE = 2;
+    static constexpr double LOCALIZER_RANGE = 25.0;         // nautical miles
+    static constexpr double LOCALIZER_WIDE_RANGE = 17.0;    // nautical miles
+    static constexpr double GLIDESLOPE_RANGE = 10.0;        // nautical miles
+
+    ILSBeamTable();
+    ILSBeamTable(const ILSSystemTable& systems, const CSV::File& ilsBase, const CSV::File& glideslope, const CSV::File& runwayEnds);
+
+    size_t size() const;
+    bool hasLocalizer(size_t system) const;
+    bool hasGlideslope(size_t system) const;
+    float getCourse(size_t system) const;           // degrees true, inbound
+    float getHalfWidth(size_t system) const;        // degrees either side of the course at full scale
+    float getGlideslopeAngle(size_t system) const;  // degrees, NaN without a glideslope
+
+    // deviation of an aircraft at altitude feet MSL from one system
+    ILSDeviation computeDeviation(size_t system, const Data::LatitudeLongitude& position, double altitude) const;
+
+    // deviations of every aircraft from every localizer within LOCALIZER_RANGE of it, ordered by
+    // aircraft then system; altitudes are feet MSL and indexed like the positions
+    std::vector<ILSDeviation> computeDeviations(const std::vector<Data::LatitudeLongitude>& positions, const std::vector<double>& altitudes, size_t threads = 0) const;
+
+private:
+    // an antenna's Earth-centered position in nautical miles and its local frame
+    struct Frame
+    {
+        double x, y, z;
+        double sinLatitude, cosLatitude;
+        double sinLongitude, cosLongitude;
+    };
+
+    static Frame MakeFrame(double latitude, double longitude, double elevation);
+    ILSDeviation evaluate(size_t system, double x, double y, double z) const;
+
+private:
+    std::vector<Frame> _localizers;
+    std::vector<Frame> _glideslopes;
+    std::vector<double> _sinCourse;
+    std::vector<double> _cosCourse;
+    std::vector<float> _course;
+    std::vector<float> _halfWidth;          // radians
+    std::vector<float> _glideslopeAngle;    // radians, NaN without a glideslope
+    std::vector<uint8_t> _hasLocalizer;
+    SpatialIndex _index;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,169 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ilsSystemTable.h"
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr uint32_t ILSSystem::NO_ROW;
+
+const std::vector<std::string> ILSSystemTable::COMPONENT_KEY{ "ARPT_ID", "RWY_END_ID", "ILS_LOC_ID" };
+const std::vector<std::string> ILSSystemTable::RUNWAY_END_KEY{ "ARPT_ID", "RWY_END_ID" };
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+uint32_t FirstRow(const CSV::RowSpan &rows)
+{
+    return rows.empty() ? ILSSystem::NO_ROW : rows[0];
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+ILSSystemTable::ILSSystemTable()
+    : _runwayEndOffsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+ILSSystemTable::ILSSystemTable(const CSV::File &ilsBase, const CSV::File &glideslope, const CSV::File &dme, const CSV::File &marker, const CSV::File &remarks, const CSV::File &runwayEnds)
+{
+    const CSV::Column airports = ilsBase.getColumn("ARPT_ID");
+    const CSV::Column ends = ilsBase.getColumn("RWY_END_ID");
+    const CSV::Column localizers = ilsBase.getColumn("ILS_LOC_ID");
+    const size_t runwayEndCount = runwayEnds.isValid() ? runwayEnds.getColumn("RWY_END_ID").get().size() : 0;
+
+    std::vector<uint32_t> endCounts(runwayEndCount, 0);
+    std::vector<std::string> key(3);
+    _systems.reserve(airports.get().size());
+    for (size_t row = 0; row < airports.get().size(); row++)
+    {
+        key[0] = airports.get()[row];
+        key[1] = ends.get()[row];
+        key[2] = localizers.get()[row];
+
+        ILSSystem system;
+        system.localizerRow = static_cast<uint32_t>(row);
+        system.runwayEndRow = runwayEnds.isValid() ? Detail::FirstRow(runwayEnds.lookupComposite(RUNWAY_END_KEY, { key[0], key[1] })) : ILSSystem::NO_ROW;
+        system.glideslopeRow = glideslope.isValid() ? Detail::FirstRow(glideslope.lookupComposite(COMPONENT_KEY, key)) : ILSSystem::NO_ROW;
+        system.dmeRow = dme.isValid() ? Detail::FirstRow(dme.lookupComposite(COMPONENT_KEY, key)) : ILSSystem::NO_ROW;
+
+        const CSV::RowSpan markers = marker.isValid() ? marker.lookupComposite(COMPONENT_KEY, key) : CSV::RowSpan();
+        system.markerOffset = static_cast<uint32_t>(_markerRows.size());
+        system.markerCount = static_cast<uint32_t>(markers.size());
+        _markerRows.insert(_markerRows.end(), markers.begin(), markers.end());
+
+        const CSV::RowSpan notes = remarks.isValid() ? remarks.lookupComposite(COMPONENT_KEY, key) : CSV::RowSpan();
+        system.remarkOffset = static_cast<uint32_t>(_remarkRows.size());
+        system.remarkCount = static_cast<uint32_t>(notes.size());
+        _remarkRows.insert(_remarkRows.end(), notes.begin(), notes.end());
+
+        if (system.runwayEndRow != ILSSystem::NO_ROW)
+        {
+            endCounts[system.runwayEndRow]++;
+        }
+        _systems.push_back(system);
+    }
+
+    // systems grouped by runway end row
+    _runwayEndOffsets.assign(runwayEndCount + 1, 0);
+    for (size_t end = 0; end < runwayEndCount; end++)
+    {
+        _runwayEndOffsets[end + 1] = _runwayEndOffsets[end] + endCounts[end];
+    }
+    std::vector<uint32_t> cursor(_runwayEndOffsets.begin(), _runwayEndOffsets.end() - 1);
+    _runwayEndSystems.resize(_runwayEndOffsets.back());
+    for (size_t index = 0; index < _systems.size(); index++)
+    {
+        const uint32_t end = _systems[index].runwayEndRow;
+        if (end != ILSSystem::NO_ROW)
+        {
+            _runwayEndSystems[cursor[end]++] = static_cast<uint32_t>(index);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t ILSSystemTable::size() const
+{
+    return _systems.size();
+}
+
+// ----------------------------------------------------------------------------
+
+const ILSSystem &ILSSystemTable::getSystem(size_t index) const
+{
+    return _systems[index];
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan ILSSystemTable::getMarkerRows(size_t index) const
+{
+    const ILSSystem &system = _systems[index];
+    return CSV::RowSpan(_markerRows.data() + system.markerOffset, _markerRows.data() + system.markerOffset + system.markerCount);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan ILSSystemTable::getRemarkRows(size_t index) const
+{
+    const ILSSystem &system = _systems[index];
+    return CSV::RowSpan(_remarkRows.data() + system.remarkOffset, _remarkRows.data() + system.remarkOffset + system.remarkCount);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan ILSSystemTable::getSystemsForRunwayEnd(size_t runwayEndRow) const
+{
+    if (runwayEndRow + 1 >= _runwayEndOffsets.size())
+    {
+        return CSV::RowSpan();
+    }
+    return CSV::RowSpan(_runwayEndSystems.data() + _runwayEndOffsets[runwayEndRow], _runwayEndSystems.data() + _runwayEndOffsets[runwayEndRow + 1]);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,95 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// one ILS system as row indices into the ILS and runway end files
+struct ILSSystem
+{
+    static constexpr uint32_t NO_ROW = 0xFFFFFFFF;
+
+    uint32_t localizerRow;      // ILS_BASE
+    uint32_t runwayEndRow;      // APT_RWY_END, NO_ROW when the runway end is not listed
+    uint32_t glideslopeRow;     // ILS_GS, NO_ROW when absent
+    uint32_t dmeRow;            // ILS_DME, NO_ROW when absent
+    uint32_t markerOffset;      // into the table's marker rows
+    uint32_t markerCount;
+    uint32_t remarkOffset;      // into the table's remark rows
+    uint32_t remarkCount;
+};
+
+// ----------------------------------------------------------------------------
+
+// Load-time join of the ILS files into one record per ILS_BASE row.  Each
+// component is matched on (ARPT_ID, RWY_END_ID, ILS_LOC_ID) and the runway end
+// on (ARPT_ID, RWY_END_ID), through the hash indexes the files must declare
+// (see ILSSystemTable::COMPONENT_KEY and RUNWAY_END_KEY).  Systems are also
+// grouped by runway end row, so the approaches serving a runway end are one
+// offset lookup away.
+class ILSSystemTable
+{
+public:
+    static const std::vector<std::string> COMPONENT_KEY;
+    static const std::vector<std::string> RUNWAY_END_KEY;
+
+    ILSSystemTable();
+    ILSSystemTable(const CSV::File& ilsBase, const CSV::File& glideslope, const CSV::File& dme, const CSV::File& marker, const CSV::File& remarks, const CSV::File& runwayEnds);
+
+    size_t size() const;
+    const ILSSystem& getSystem(size_t index) const;
+    CSV::RowSpan getMarkerRows(size_t index) const;
+    CSV::RowSpan getRemarkRows(size_t index) const;
+
+    // indices of the systems serving a row of APT_RWY_END
+    CSV::RowSpan getSystemsForRunwayEnd(size_t runwayEndRow) const;
+
+private:
+    std::vector<ILSSystem> _systems;
+    std::vector<uint32_t> _markerRows;
+    std::vector<uint32_t> _remarkRows;
+    std::vector<uint32_t> _runwayEndOffsets;    // runway end rows + 1 entries into _runwayEndSystems
+    std::vector<uint32_t> _runwayEndSystems;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,141 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace NASR
+{
+
+namespace Parallel
+{
+
+// ----------------------------------------------------------------------------
+
+// resolves a requested thread count, where zero means one per hardware thread
+size_t GetThreadCount(size_t requested = 0);
+
+// ----------------------------------------------------------------------------
+
+// splits [0, count) into one contiguous range per thread and invokes
+// body(begin, end, threadIndex) for each; the calling thread takes the first range.
+// An exception thrown by the body is rethrown on the calling thread once every
+// range has finished, the one from the lowest thread index when several throw
+template <typename TBody>
+void For(size_t count, size_t threads, TBody body)
+{
+    threads = std::max<size_t>(1, std::min(GetThreadCount(threads), count));
+    if (threads <= 1)
+    {
+        body(static_cast<size_t>(0), count, static_cast<size_t>(0));
+        return;
+    }
+
+    const size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::exception_ptr> failures(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t thread = 1; thread < threads; thread++)
+    {
+        const size_t begin = std::min(count, thread * chunk);
+        const size_t end = std::min(count, begin + chunk);
+        workers.emplace_back([&body, &failures, begin, end, thread]()
+        {
+            try
+            {
+                body(begin, end, thread);
+            }
+            catch (...)
+            {
+                failures[thread] = std::current_exception();
+            }
+        });
+    }
+    try
+    {
+        body(static_cast<size_t>(0), std::min(count, chunk), static_cast<size_t>(0));
+    }
+    catch (...)
+    {
+        failures[0] = std::current_exception();
+    }
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    for (const std::exception_ptr &failure : failures)
+    {
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// as For, but each thread keeps claiming the next chunk of grain items from a
+// shared counter until none are left, which balances chunks of uneven cost;
+// chunks are claimed in ascending order
+template <typename TBody>
+void ForDynamic(size_t count, size_t grain, size_t threads, TBody body)
+{
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = (count + grain - 1) / grain;
+    std::atomic<size_t> next(0);
+    For(std::min(GetThreadCount(threads), chunks), threads, [&](size_t, size_t, size_t thread)
+    {
+        for (size_t chunk = next++; chunk < chunks; chunk = next++)
+        {
+            body(chunk * grain, std::min(count, chunk * grain + grain), thread);
+        }
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+// runs every task and returns once all of them have finished, e.g. by
+// submitting them to a thread pool and waiting on the results
+typedef std::function<void(const std::vector<std::function<void()>>& tasks)> Executor;
+
+// ----------------------------------------------------------------------------
+
+} // namespace Parallel
+
+} // namespace NASR
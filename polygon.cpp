@@ -0,0 +1,189 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "polygon.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace NASR
+{
+
+namespace Geo
+{
+
+// ----------------------------------------------------------------------------
+
+Polygon::Polygon()
+    : _box{ 0.0, 0.0, 0.0, 0.0 }, _slabHeight(1.0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+Polygon::Polygon(const std::vector<Data::LatitudeLongitude> &vertices, size_t slabCount)
+    : _box(BoundingBox::Enclosing(vertices)), _slabHeight(1.0)
+{
+    const size_t vertexCount = vertices.size();
+    if (vertexCount < 3)
+    {
+        _box = BoundingBox{ 0.0, 0.0, 0.0, 0.0 };
+        return;
+    }
+
+    if (slabCount == 0)
+    {
+        slabCount = std::min<size_t>(vertexCount, 1024);
+    }
+    _slabHeight = std::max((_box.maxLatitude - _box.minLatitude) / slabCount, 1e-9);
+
+    // count the edges in each slab, then fill them in a second pass
+    std::vector<uint32_t> counts(slabCount + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::vector<uint32_t> cursor;
+        if (pass == 1)
+        {
+            _slabStart.assign(slabCount + 1, 0);
+            for (size_t slab = 0; slab < slabCount; slab++)
+            {
+                _slabStart[slab + 1] = _slabStart[slab] + counts[slab];
+            }
+            _edgeLatitude0.resize(_slabStart.back());
+            _edgeLatitude1.resize(_slabStart.back());
+            _edgeLongitude0.resize(_slabStart.back());
+            _edgeSlope.resize(_slabStart.back());
+            cursor.assign(_slabStart.begin(), _slabStart.end() - 1);
+        }
+
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            const Data::LatitudeLongitude &a = vertices[i];
+            const Data::LatitudeLongitude &b = vertices[(i + 1) % vertexCount];
+            if (a.getLatitude() == b.getLatitude())
+            {
+                // horizontal edges never cross a horizontal ray
+                continue;
+            }
+
+            const size_t first = getSlab(std::min(a.getLatitude(), b.getLatitude()));
+            const size_t last = std::min(getSlab(std::max(a.getLatitude(), b.getLatitude())), slabCount - 1);
+            for (size_t slab = first; slab <= last; slab++)
+            {
+                if (pass == 0)
+                {
+                    counts[slab]++;
+                    continue;
+                }
+                const uint32_t edge = cursor[slab]++;
+                _edgeLatitude0[edge] = a.getLatitude();
+                _edgeLatitude1[edge] = b.getLatitude();
+                _edgeLongitude0[edge] = a.getLongitude();
+                _edgeSlope[edge] = (b.getLongitude() - a.getLongitude()) / (b.getLatitude() - a.getLatitude());
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool Polygon::empty() const
+{
+    return _slabStart.empty();
+}
+
+// ----------------------------------------------------------------------------
+
+const BoundingBox &Polygon::getBoundingBox() const
+{
+    return _box;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t Polygon::getSlab(double latitude) const
+{
+    const double slab = std::floor((latitude - _box.minLatitude) / _slabHeight);
+    return static_cast<size_t>(std::max(0.0, slab));
+}
+
+// ----------------------------------------------------------------------------
+
+bool Polygon::contains(double latitude, double longitude) const
+{
+    uint8_t out = 0;
+    contains(&latitude, &longitude, 1, &out);
+    return out != 0;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Polygon::contains(const Data::LatitudeLongitude &point) const
+{
+    return point.valid() && contains(point.getLatitude(), point.getLongitude());
+}
+
+// ----------------------------------------------------------------------------
+
+void Polygon::contains(const double *latitudes, const double *longitudes, size_t count, uint8_t *out) const
+{
+    const size_t slabCount = _slabStart.empty() ? 0 : _slabStart.size() - 1;
+    for (size_t i = 0; i < count; i++)
+    {
+        const double latitude = latitudes[i];
+        const double longitude = longitudes[i];
+        if (slabCount == 0 || !_box.contains(latitude, longitude))
+        {
+            out[i] = 0;
+            continue;
+        }
+
+        const size_t slab = std::min(getSlab(latitude), slabCount - 1);
+        const uint32_t end = _slabStart[slab + 1];
+
+        // crossing number test against a ray pointing east; branch-free so the
+        // loop over the slab's edges vectorizes
+        uint32_t crossings = 0;
+        for (uint32_t edge = _slabStart[slab]; edge < end; edge++)
+        {
+            const bool spans = (_edgeLatitude0[edge] > latitude) != (_edgeLatitude1[edge] > latitude);
+            const bool east = longitude < _edgeLongitude0[edge] + (latitude - _edgeLatitude0[edge]) * _edgeSlope[edge];
+            crossings += static_cast<uint32_t>(spans & east);
+        }
+        out[i] = static_cast<uint8_t>(crossings & 1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Geo
+
+} // namespace NASR
@@ -0,0 +1,87 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "data.h"
+#include "geo.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace NASR
+{
+
+namespace Geo
+{
+
+// ----------------------------------------------------------------------------
+
+// A simple (possibly concave) polygon whose edges are straight lines in
+// latitude/longitude space.  Edges are bucketed into latitude slabs so that a
+// containment test only visits the edges that span the point's latitude,
+// which keeps outlines with thousands of vertices cheap to test against.
+// Polygons may be given open or closed and must not cross the antimeridian.
+class Polygon
+{
+public:
+    Polygon();
+    Polygon(const std::vector<Data::LatitudeLongitude>& vertices, size_t slabCount = 0);
+
+    bool empty() const;
+    const BoundingBox& getBoundingBox() const;
+
+    bool contains(double latitude, double longitude) const;
+    bool contains(const Data::LatitudeLongitude& point) const;
+
+    // tests count packed coordinates at once, writing 1 (inside) or 0 (outside) to out
+    void contains(const double* latitudes, const double* longitudes, size_t count, uint8_t* out) const;
+
+private:
+    size_t getSlab(double latitude) const;
+
+private:
+    BoundingBox _box;
+    double _slabHeight;
+
+    // edges grouped by slab, stored as parallel arrays
+    std::vector<uint32_t> _slabStart;
+    std::vector<double> _edgeLatitude0;
+    std::vector<double> _edgeLatitude1;
+    std::vector<double> _edgeLongitude0;
+    std::vector<double> _edgeSlope; // change in longitude per degree of latitude
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Geo
+
+} // namespace NASR
@@ -0,0 +1,947 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "queryEngine.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr size_t QueryEngine::BLOCK_SIZE;
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+// strict parse that rejects trailing text and identifier-like leading zeros ("07", "0042")
+tl::optional<double> ParseColumnNumber(const std::string &value)
+{
+    const size_t digits = value[0] == '-' || value[0] == '+' ? 1 : 0;
+    if (value.size() > digits + 1 && value[digits] == '0' && value[digits + 1] != '.')
+    {
+        return tl::nullopt;
+    }
+    char *end = nullptr;
+    const double number = std::strtod(value.c_str(), &end);
+    if (end != value.c_str() + value.size() || !std::isfinite(number))
+    {
+        return tl::nullopt;
+    }
+    return number;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TestBit(const std::vector<uint64_t> &bits, size_t index)
+{
+    return (bits[index >> 6] >> (index & 63)) & 1;
+}
+
+// ----------------------------------------------------------------------------
+
+void SetBit(std::vector<uint64_t> &bits, size_t index)
+{
+    bits[index >> 6] |= uint64_t(1) << (index & 63);
+}
+
+// ----------------------------------------------------------------------------
+
+// a predicate with its columns resolved and its constants translated to the column types
+struct CompiledPredicate
+{
+    Predicate::Operation operation;
+    std::shared_ptr<const TypedColumn> column;
+    std::vector<uint8_t> codeMask;          // IN on codes, indexed by code with the null code last
+    std::vector<double> numbers;            // IN on numbers
+    double minimum;
+    double maximum;
+    std::vector<uint64_t> rowMask;          // ANY, one bit per row of the selected file
+    std::vector<CompiledPredicate> children;
+};
+
+// ----------------------------------------------------------------------------
+
+// rows of a that are not in b, both ascending
+size_t Difference(const uint32_t *a, size_t aCount, const uint32_t *b, size_t bCount, uint32_t *out)
+{
+    size_t count = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < aCount; i++)
+    {
+        while (j < bCount && b[j] < a[i])
+        {
+            j++;
+        }
+        if (j == bCount || b[j] != a[i])
+        {
+            out[count++] = a[i];
+        }
+    }
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+
+// narrows the ascending selection in[0, count) to the rows matching the
+// predicate, writing them to out, which may alias in; returns the new count
+size_t Evaluate(const CompiledPredicate &predicate, const uint32_t *in, size_t count, uint32_t *out)
+{
+    size_t selected = 0;
+    switch (predicate.operation)
+    {
+    case Predicate::Operation::IN:
+        if (predicate.column->getKind() == TypedColumn::Kind::CODE)
+        {
+            const uint32_t *codes = predicate.column->getCodes().data();
+            const uint8_t *mask = predicate.codeMask.data();
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint32_t row = in[i];
+                out[selected] = row;
+                selected += mask[codes[row]];
+            }
+        }
+        else
+        {
+            const double *values = predicate.column->getNumbers().data();
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint32_t row = in[i];
+                out[selected] = row;
+                selected += std::find(predicate.numbers.begin(), predicate.numbers.end(), values[row]) != predicate.numbers.end();
+            }
+        }
+        return selected;
+
+    case Predicate::Operation::BETWEEN:
+    {
+        // NaN fails both comparisons, so nulls drop out without a bitmap test
+        const double *values = predicate.column->getNumbers().data();
+        const double minimum = predicate.minimum;
+        const double maximum = predicate.maximum;
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint32_t row = in[i];
+            const double value = values[row];
+            out[selected] = row;
+            selected += (value >= minimum) & (value <= maximum);
+        }
+        return selected;
+    }
+
+    case Predicate::Operation::IS_NULL:
+    case Predicate::Operation::ANY:
+    {
+        const std::vector<uint64_t> &bits = predicate.operation == Predicate::Operation::ANY ? predicate.rowMask : predicate.column->getNullBitmap();
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint32_t row = in[i];
+            out[selected] = row;
+            selected += TestBit(bits, row);
+        }
+        return selected;
+    }
+
+    case Predicate::Operation::AND:
+        selected = count;
+        for (const CompiledPredicate &child : predicate.children)
+        {
+            selected = Evaluate(child, in, selected, out);
+            in = out;
+        }
+        if (predicate.children.empty() && out != in)
+        {
+            std::copy(in, in + count, out);
+        }
+        return selected;
+
+    case Predicate::Operation::OR:
+    {
+        // each child only sees the rows no earlier child matched
+        std::vector<uint32_t> matched;
+        std::vector<uint32_t> remaining(in, in + count);
+        std::vector<uint32_t> scratch(count);
+        for (const CompiledPredicate &child : predicate.children)
+        {
+            const size_t hits = Evaluate(child, remaining.data(), remaining.size(), scratch.data());
+            const size_t left = Difference(remaining.data(), remaining.size(), scratch.data(), hits, remaining.data());
+            const size_t previous = matched.size();
+            matched.insert(matched.end(), scratch.begin(), scratch.begin() + hits);
+            std::inplace_merge(matched.begin(), matched.begin() + previous, matched.end());
+            remaining.resize(left);
+        }
+        std::copy(matched.begin(), matched.end(), out);
+        return matched.size();
+    }
+
+    case Predicate::Operation::NOT:
+    default:
+    {
+        std::vector<uint32_t> scratch(count);
+        const size_t hits = Evaluate(predicate.children[0], in, count, scratch.data());
+        return Difference(in, count, scratch.data(), hits, out);
+    }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+struct Accumulator
+{
+    size_t count;
+    double sum;
+    double minimum;
+    double maximum;
+};
+
+// ----------------------------------------------------------------------------
+
+// open-addressing table from packed group keys to dense group slots, each
+// holding a row count and one accumulator per aggregation
+class GroupTable
+{
+public:
+    GroupTable(size_t aggregations)
+        : _aggregations(aggregations), _slots(64, 0)
+    {
+    }
+
+    size_t size() const
+    {
+        return keys.size();
+    }
+
+    size_t findOrInsert(uint64_t key)
+    {
+        size_t slot = Hash(key) & (_slots.size() - 1);
+        while (_slots[slot] != 0)
+        {
+            const size_t group = _slots[slot] - 1;
+            if (keys[group] == key)
+            {
+                return group;
+            }
+            slot = (slot + 1) & (_slots.size() - 1);
+        }
+
+        const size_t group = keys.size();
+        _slots[slot] = static_cast<uint32_t>(group + 1);
+        keys.push_back(key);
+        rowCounts.push_back(0);
+        accumulators.resize(accumulators.size() + _aggregations, Accumulator{ 0, 0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() });
+        if (keys.size() * 2 > _slots.size())
+        {
+            grow();
+        }
+        return group;
+    }
+
+    std::vector<uint64_t> keys;
+    std::vector<size_t> rowCounts;
+    std::vector<Accumulator> accumulators;  // groups x aggregations
+
+private:
+    static uint64_t Hash(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDull;
+        key ^= key >> 33;
+        return key;
+    }
+
+    void grow()
+    {
+        _slots.assign(_slots.size() * 2, 0);
+        for (size_t group = 0; group < keys.size(); group++)
+        {
+            size_t slot = Hash(keys[group]) & (_slots.size() - 1);
+            while (_slots[slot] != 0)
+            {
+                slot = (slot + 1) & (_slots.size() - 1);
+            }
+            _slots[slot] = static_cast<uint32_t>(group + 1);
+        }
+    }
+
+private:
+    size_t _aggregations;
+    std::vector<uint32_t> _slots;           // group + 1, or 0 when empty
+};
+
+// ----------------------------------------------------------------------------
+
+void Accumulate(Accumulator &accumulator, double value)
+{
+    if (std::isnan(value))
+    {
+        return;
+    }
+    accumulator.count++;
+    accumulator.sum += value;
+    accumulator.minimum = std::min(accumulator.minimum, value);
+    accumulator.maximum = std::max(accumulator.maximum, value);
+}
+
+// ----------------------------------------------------------------------------
+
+void Merge(Accumulator &into, const Accumulator &from)
+{
+    into.count += from.count;
+    into.sum += from.sum;
+    into.minimum = std::min(into.minimum, from.minimum);
+    into.maximum = std::max(into.maximum, from.maximum);
+}
+
+// ----------------------------------------------------------------------------
+
+std::string FormatNumber(double value)
+{
+    std::ostringstream out;
+    out << std::setprecision(15) << value;
+    return out.str();
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+TypedColumn::TypedColumn()
+    : _kind(Kind::CODE), _size(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+TypedColumn::TypedColumn(const std::vector<std::string> &values)
+    : _kind(Kind::NUMBER), _size(values.size()), _nulls((values.size() + 63) / 64, 0)
+{
+    _numbers.reserve(values.size());
+    for (size_t row = 0; row < values.size(); row++)
+    {
+        if (values[row].empty())
+        {
+            Detail::SetBit(_nulls, row);
+            _numbers.push_back(std::numeric_limits<double>::quiet_NaN());
+            continue;
+        }
+        const tl::optional<double> number = Detail::ParseColumnNumber(values[row]);
+        if (!number)
+        {
+            _kind = Kind::CODE;
+            break;
+        }
+        _numbers.push_back(*number);
+    }
+    if (_kind == Kind::NUMBER)
+    {
+        return;
+    }
+
+    _numbers.clear();
+    _numbers.shrink_to_fit();
+    std::fill(_nulls.begin(), _nulls.end(), 0);
+    for (const std::string &value : values)
+    {
+        if (!value.empty())
+        {
+            _dictionary.push_back(value);
+        }
+    }
+    std::sort(_dictionary.begin(), _dictionary.end());
+    _dictionary.erase(std::unique(_dictionary.begin(), _dictionary.end()), _dictionary.end());
+
+    _codes.reserve(values.size());
+    for (size_t row = 0; row < values.size(); row++)
+    {
+        if (values[row].empty())
+        {
+            Detail::SetBit(_nulls, row);
+            _codes.push_back(getNullCode());
+        }
+        else
+        {
+            _codes.push_back(static_cast<uint32_t>(std::lower_bound(_dictionary.begin(), _dictionary.end(), values[row]) - _dictionary.begin()));
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+TypedColumn::Kind TypedColumn::getKind() const
+{
+    return _kind;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t TypedColumn::size() const
+{
+    return _size;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TypedColumn::isNull(size_t row) const
+{
+    return Detail::TestBit(_nulls, row);
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint64_t> &TypedColumn::getNullBitmap() const
+{
+    return _nulls;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<double> &TypedColumn::getNumbers() const
+{
+    return _numbers;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &TypedColumn::getCodes() const
+{
+    return _codes;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<std::string> &TypedColumn::getDictionary() const
+{
+    return _dictionary;
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t TypedColumn::getNullCode() const
+{
+    return static_cast<uint32_t>(_dictionary.size());
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<uint32_t> TypedColumn::findCode(const std::string &value) const
+{
+    std::vector<std::string>::const_iterator search = std::lower_bound(_dictionary.begin(), _dictionary.end(), value);
+    if (search == _dictionary.end() || *search != value)
+    {
+        return tl::nullopt;
+    }
+    return static_cast<uint32_t>(search - _dictionary.begin());
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate::Predicate(Node node)
+    : _node(std::make_shared<const Node>(std::move(node)))
+{
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::Equals(const std::string &column, const std::string &value)
+{
+    return In(column, { value });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::In(const std::string &column, const std::vector<std::string> &values)
+{
+    return Predicate(Node{ Operation::IN, column, values, 0.0, 0.0, SourceFile::APT_BASE, {} });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::Between(const std::string &column, double minimum, double maximum)
+{
+    return Predicate(Node{ Operation::BETWEEN, column, {}, minimum, maximum, SourceFile::APT_BASE, {} });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::AtLeast(const std::string &column, double minimum)
+{
+    return Between(column, minimum, std::numeric_limits<double>::infinity());
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::AtMost(const std::string &column, double maximum)
+{
+    return Between(column, -std::numeric_limits<double>::infinity(), maximum);
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::IsNull(const std::string &column)
+{
+    return Predicate(Node{ Operation::IS_NULL, column, {}, 0.0, 0.0, SourceFile::APT_BASE, {} });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::Any(SourceFile file, const Predicate &predicate)
+{
+    return Predicate(Node{ Operation::ANY, "", {}, 0.0, 0.0, file, { predicate } });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::operator&&(const Predicate &other) const
+{
+    // flatten chains so a && b && c evaluates as one narrowing pass
+    std::vector<Predicate> children;
+    for (const Predicate *side : { this, &other })
+    {
+        if (side->getNode().operation == Operation::AND)
+        {
+            children.insert(children.end(), side->getNode().children.begin(), side->getNode().children.end());
+        }
+        else
+        {
+            children.push_back(*side);
+        }
+    }
+    return Predicate(Node{ Operation::AND, "", {}, 0.0, 0.0, SourceFile::APT_BASE, children });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::operator||(const Predicate &other) const
+{
+    std::vector<Predicate> children;
+    for (const Predicate *side : { this, &other })
+    {
+        if (side->getNode().operation == Operation::OR)
+        {
+            children.insert(children.end(), side->getNode().children.begin(), side->getNode().children.end());
+        }
+        else
+        {
+            children.push_back(*side);
+        }
+    }
+    return Predicate(Node{ Operation::OR, "", {}, 0.0, 0.0, SourceFile::APT_BASE, children });
+}
+
+// ----------------------------------------------------------------------------
+
+Predicate Predicate::operator!() const
+{
+    return Predicate(Node{ Operation::NOT, "", {}, 0.0, 0.0, SourceFile::APT_BASE, { *this } });
+}
+
+// ----------------------------------------------------------------------------
+
+const Predicate::Node &Predicate::getNode() const
+{
+    return *_node;
+}
+
+// ----------------------------------------------------------------------------
+
+QueryEngine::QueryEngine()
+    : _cache(std::make_shared<Cache>())
+{
+}
+
+// ----------------------------------------------------------------------------
+
+std::shared_ptr<const TypedColumn> QueryEngine::getColumn(const std::vector<const CSV::File *> &files, SourceFile file, const std::string &name) const
+{
+    std::lock_guard<std::mutex> lock(_cache->mutex);
+    std::shared_ptr<const TypedColumn> &column = _cache->columns[static_cast<size_t>(file)][name];
+    if (!column)
+    {
+        try
+        {
+            column = std::make_shared<const TypedColumn>(files[static_cast<size_t>(file)]->getColumn(name).get());
+        }
+        catch (...)
+        {
+            _cache->columns[static_cast<size_t>(file)].erase(name);
+            throw;
+        }
+    }
+    return column;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> QueryEngine::select(const std::vector<const CSV::File *> &files, SourceFile file, const Predicate &predicate, size_t threads) const
+{
+    // resolves columns and constants, and evaluates ANY subtrees into row masks
+    std::function<Detail::CompiledPredicate(const Predicate &, SourceFile)> compile = [&](const Predicate &source, SourceFile target)
+    {
+        const Predicate::Node &node = source.getNode();
+        Detail::CompiledPredicate compiled{ node.operation, nullptr, {}, {}, node.minimum, node.maximum, {}, {} };
+        switch (node.operation)
+        {
+        case Predicate::Operation::IN:
+            compiled.column = getColumn(files, target, node.column);
+            if (compiled.column->getKind() == TypedColumn::Kind::CODE)
+            {
+                compiled.codeMask.assign(compiled.column->getDictionary().size() + 1, 0);
+                for (const std::string &value : node.values)
+                {
+                    const tl::optional<uint32_t> code = compiled.column->findCode(value);
+                    if (code)
+                    {
+                        compiled.codeMask[*code] = 1;
+                    }
+                }
+            }
+            else
+            {
+                for (const std::string &value : node.values)
+                {
+                    const tl::optional<double> number = value.empty() ? tl::nullopt : CSV::Utils::ParseOptional<double>(value);
+                    if (number)
+                    {
+                        compiled.numbers.push_back(*number);
+                    }
+                }
+            }
+            break;
+
+        case Predicate::Operation::BETWEEN:
+            compiled.column = getColumn(files, target, node.column);
+            if (compiled.column->getKind() != TypedColumn::Kind::NUMBER)
+            {
+                throw std::invalid_argument("column " + node.column + " is not numeric");
+            }
+            break;
+
+        case Predicate::Operation::IS_NULL:
+            compiled.column = getColumn(files, target, node.column);
+            break;
+
+        case Predicate::Operation::ANY:
+        {
+            // airports with a matching row in the other file, spread onto the rows of this one
+            const std::vector<size_t> rows = select(files, node.file, node.children[0], threads);
+            const std::shared_ptr<const TypedColumn> airports = getColumn(files, node.file, "ARPT_ID");
+            const CSV::File &targetFile = *files[static_cast<size_t>(target)];
+            compiled.rowMask.assign((getColumn(files, target, "ARPT_ID")->size() + 63) / 64, 0);
+            const auto markAirport = [&compiled, &targetFile](const std::string &airport)
+            {
+                for (uint32_t match : targetFile.lookup("ARPT_ID", airport))
+                {
+                    Detail::SetBit(compiled.rowMask, match);
+                }
+            };
+            if (airports->getKind() == TypedColumn::Kind::CODE)
+            {
+                std::vector<uint8_t> seen(airports->getDictionary().size() + 1, 0);
+                seen[airports->getNullCode()] = 1;
+                for (size_t row : rows)
+                {
+                    const uint32_t code = airports->getCodes()[row];
+                    if (!seen[code])
+                    {
+                        seen[code] = 1;
+                        markAirport(airports->getDictionary()[code]);
+                    }
+                }
+            }
+            else
+            {
+                // identifiers that all look like numbers are not dictionary coded
+                const CSV::Column identifiers = files[static_cast<size_t>(node.file)]->getColumn("ARPT_ID");
+                for (size_t row : rows)
+                {
+                    markAirport(identifiers.get()[row]);
+                }
+            }
+            break;
+        }
+
+        case Predicate::Operation::AND:
+        case Predicate::Operation::OR:
+        case Predicate::Operation::NOT:
+        default:
+            for (const Predicate &child : node.children)
+            {
+                compiled.children.push_back(compile(child, target));
+            }
+            break;
+        }
+        return compiled;
+    };
+
+    const size_t rowCount = getColumn(files, file, "ARPT_ID")->size();
+    const Detail::CompiledPredicate compiled = compile(predicate, file);
+
+    const size_t blockCount = (rowCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    threads = std::max<size_t>(1, std::min(Parallel::GetThreadCount(threads), blockCount));
+    std::vector<std::vector<size_t>> partial(threads);
+    Parallel::For(blockCount, threads, [&](size_t begin, size_t end, size_t thread)
+    {
+        std::vector<uint32_t> selection(BLOCK_SIZE);
+        for (size_t block = begin; block < end; block++)
+        {
+            const size_t first = block * BLOCK_SIZE;
+            const size_t count = std::min(BLOCK_SIZE, rowCount - first);
+            for (size_t i = 0; i < count; i++)
+            {
+                selection[i] = static_cast<uint32_t>(first + i);
+            }
+            const size_t selected = Detail::Evaluate(compiled, selection.data(), count, selection.data());
+            partial[thread].insert(partial[thread].end(), selection.begin(), selection.begin() + selected);
+        }
+    });
+
+    std::vector<size_t> out;
+    for (const std::vector<size_t> &rows : partial)
+    {
+        out.insert(out.end(), rows.begin(), rows.end());
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<AggregateGroup> QueryEngine::aggregate(const std::vector<const CSV::File *> &files, SourceFile file, const std::vector<std::string> &groupBy, const std::vector<Aggregation> &aggregations, size_t threads) const
+{
+    return aggregateRows(files, file, nullptr, groupBy, aggregations, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<AggregateGroup> QueryEngine::aggregate(const std::vector<const CSV::File *> &files, SourceFile file, const Predicate &predicate, const std::vector<std::string> &groupBy, const std::vector<Aggregation> &aggregations, size_t threads) const
+{
+    const std::vector<size_t> rows = select(files, file, predicate, threads);
+    return aggregateRows(files, file, &rows, groupBy, aggregations, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<AggregateGroup> QueryEngine::aggregateRows(const std::vector<const CSV::File *> &files, SourceFile file, const std::vector<size_t> *rows, const std::vector<std::string> &groupBy, const std::vector<Aggregation> &aggregations, size_t threads) const
+{
+    // every group-by column is reduced to dense codes with null last, and a
+    // row's codes are packed into one mixed-radix key whose order is the
+    // order of the key tuples
+    struct KeyColumn
+    {
+        std::shared_ptr<const TypedColumn> column;
+        std::vector<uint32_t> numberCodes;      // NUMBER columns, indexes into numbers
+        std::vector<double> numbers;            // distinct values, ascending
+        uint64_t radix;
+        uint64_t multiplier;
+    };
+    std::vector<KeyColumn> keyColumns(groupBy.size());
+    for (size_t k = 0; k < groupBy.size(); k++)
+    {
+        KeyColumn &key = keyColumns[k];
+        key.column = getColumn(files, file, groupBy[k]);
+        if (key.column->getKind() == TypedColumn::Kind::NUMBER)
+        {
+            const std::vector<double> &values = key.column->getNumbers();
+            for (double value : values)
+            {
+                if (!std::isnan(value))
+                {
+                    key.numbers.push_back(value);
+                }
+            }
+            std::sort(key.numbers.begin(), key.numbers.end());
+            key.numbers.erase(std::unique(key.numbers.begin(), key.numbers.end()), key.numbers.end());
+            key.numberCodes.reserve(values.size());
+            for (double value : values)
+            {
+                key.numberCodes.push_back(static_cast<uint32_t>(std::isnan(value) ? key.numbers.size() : std::lower_bound(key.numbers.begin(), key.numbers.end(), value) - key.numbers.begin()));
+            }
+            key.radix = key.numbers.size() + 1;
+        }
+        else
+        {
+            key.radix = key.column->getNullCode() + 1;
+        }
+    }
+    uint64_t keySpace = 1;
+    for (size_t k = groupBy.size(); k-- > 0;)
+    {
+        keyColumns[k].multiplier = keySpace;
+        if (keySpace > std::numeric_limits<uint64_t>::max() / keyColumns[k].radix)
+        {
+            throw std::invalid_argument("too many distinct group-by values");
+        }
+        keySpace *= keyColumns[k].radix;
+    }
+
+    // aggregated columns; only COUNT accepts non-numeric columns
+    std::vector<std::vector<std::shared_ptr<const TypedColumn>>> valueColumns(aggregations.size());
+    for (size_t a = 0; a < aggregations.size(); a++)
+    {
+        for (const std::string &name : aggregations[a].columns)
+        {
+            valueColumns[a].push_back(getColumn(files, file, name));
+            if (aggregations[a].function != AggregateFunction::COUNT && valueColumns[a].back()->getKind() != TypedColumn::Kind::NUMBER)
+            {
+                throw std::invalid_argument("column " + name + " is not numeric");
+            }
+        }
+    }
+    const auto rowValue = [&valueColumns](size_t aggregation, size_t row)
+    {
+        if (valueColumns[aggregation].empty())
+        {
+            return 1.0;
+        }
+        double sum = std::numeric_limits<double>::quiet_NaN();
+        for (const std::shared_ptr<const TypedColumn> &column : valueColumns[aggregation])
+        {
+            const double value = column->getKind() == TypedColumn::Kind::NUMBER ? column->getNumbers()[row] : (column->isNull(row) ? std::numeric_limits<double>::quiet_NaN() : 1.0);
+            if (!std::isnan(value))
+            {
+                sum = std::isnan(sum) ? value : sum + value;
+            }
+        }
+        return sum;
+    };
+
+    const size_t rowCount = rows ? rows->size() : getColumn(files, file, "ARPT_ID")->size();
+    threads = std::max<size_t>(1, std::min(Parallel::GetThreadCount(threads), rowCount / BLOCK_SIZE + 1));
+    std::vector<Detail::GroupTable> partial(threads, Detail::GroupTable(aggregations.size()));
+    Parallel::For(rowCount, threads, [&](size_t begin, size_t end, size_t thread)
+    {
+        Detail::GroupTable &table = partial[thread];
+        for (size_t i = begin; i < end; i++)
+        {
+            const size_t row = rows ? (*rows)[i] : i;
+            uint64_t key = 0;
+            for (const KeyColumn &column : keyColumns)
+            {
+                const uint32_t code = column.column->getKind() == TypedColumn::Kind::NUMBER ? column.numberCodes[row] : column.column->getCodes()[row];
+                key += code * column.multiplier;
+            }
+            const size_t group = table.findOrInsert(key);
+            table.rowCounts[group]++;
+            for (size_t a = 0; a < aggregations.size(); a++)
+            {
+                Detail::Accumulate(table.accumulators[group * aggregations.size() + a], rowValue(a, row));
+            }
+        }
+    });
+
+    Detail::GroupTable &merged = partial[0];
+    for (size_t thread = 1; thread < partial.size(); thread++)
+    {
+        const Detail::GroupTable &table = partial[thread];
+        for (size_t group = 0; group < table.size(); group++)
+        {
+            const size_t into = merged.findOrInsert(table.keys[group]);
+            merged.rowCounts[into] += table.rowCounts[group];
+            for (size_t a = 0; a < aggregations.size(); a++)
+            {
+                Detail::Merge(merged.accumulators[into * aggregations.size() + a], table.accumulators[group * aggregations.size() + a]);
+            }
+        }
+    }
+
+    std::vector<size_t> order(merged.size());
+    for (size_t group = 0; group < order.size(); group++)
+    {
+        order[group] = group;
+    }
+    std::sort(order.begin(), order.end(), [&merged](size_t a, size_t b)
+    {
+        return merged.keys[a] < merged.keys[b];
+    });
+
+    std::vector<AggregateGroup> out;
+    out.reserve(order.size());
+    for (size_t group : order)
+    {
+        AggregateGroup result{ {}, merged.rowCounts[group], {} };
+        for (const KeyColumn &column : keyColumns)
+        {
+            const size_t code = static_cast<size_t>((merged.keys[group] / column.multiplier) % column.radix);
+            if (code + 1 == column.radix)
+            {
+                result.key.push_back("");
+            }
+            else
+            {
+                result.key.push_back(column.column->getKind() == TypedColumn::Kind::NUMBER ? Detail::FormatNumber(column.numbers[code]) : column.column->getDictionary()[code]);
+            }
+        }
+        for (size_t a = 0; a < aggregations.size(); a++)
+        {
+            const Detail::Accumulator &accumulator = merged.accumulators[group * aggregations.size() + a];
+            switch (aggregations[a].function)
+            {
+            case AggregateFunction::COUNT:
+                result.values.push_back(static_cast<double>(accumulator.count));
+                break;
+            case AggregateFunction::SUM:
+                result.values.push_back(accumulator.count ? tl::optional<double>(accumulator.sum) : tl::nullopt);
+                break;
+            case AggregateFunction::MINIMUM:
+                result.values.push_back(accumulator.count ? tl::optional<double>(accumulator.minimum) : tl::nullopt);
+                break;
+            case AggregateFunction::MAXIMUM:
+                result.values.push_back(accumulator.count ? tl::optional<double>(accumulator.maximum) : tl::nullopt);
+                break;
+            case AggregateFunction::AVERAGE:
+            default:
+                result.values.push_back(accumulator.count ? tl::optional<double>(accumulator.sum / accumulator.count) : tl::nullopt);
+                break;
+            }
+        }
+        out.push_back(std::move(result));
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,238 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+enum class SourceFile
+{
+    APT_BASE,
+    APT_ARS,
+    APT_ATT,
+    APT_CON,
+    APT_RMK,
+    APT_RWY,
+    APT_RWY_END,
+    ILS_BASE,
+    ILS_GS,
+    ILS_DME,
+    ILS_MKR,
+    ILS_RMK
+};
+
+constexpr size_t SOURCE_FILE_COUNT = 12;
+
+// ----------------------------------------------------------------------------
+
+// Decoded copy of one CSV column.  Columns whose non-empty values all parse
+// as numbers are stored as doubles, anything else as codes into a sorted
+// dictionary of distinct values; empty values are null either way, which is
+// NaN for numbers and getNullCode() for codes.
+class TypedColumn
+{
+public:
+    enum class Kind
+    {
+        NUMBER,
+        CODE
+    };
+
+    TypedColumn();
+    TypedColumn(const std::vector<std::string>& values);
+
+    Kind getKind() const;
+    size_t size() const;
+    bool isNull(size_t row) const;
+    const std::vector<uint64_t>& getNullBitmap() const;    // one bit per row, set when null
+
+    const std::vector<double>& getNumbers() const;          // NUMBER columns only
+    const std::vector<uint32_t>& getCodes() const;          // CODE columns only
+    const std::vector<std::string>& getDictionary() const;
+    uint32_t getNullCode() const;
+    tl::optional<uint32_t> findCode(const std::string& value) const;
+
+private:
+    Kind _kind;
+    size_t _size;
+    std::vector<uint64_t> _nulls;
+    std::vector<double> _numbers;
+    std::vector<uint32_t> _codes;
+    std::vector<std::string> _dictionary;
+};
+
+// ----------------------------------------------------------------------------
+
+// Predicate tree over the columns of one file, e.g. public-use towered
+// airports above 4000 ft with a paved runway of 5000 ft or more:
+//
+//     Predicate::Equals("FACILITY_USE_CODE", "PU") &&
+//     Predicate::In("TWR_TYPE_CODE", { "ATCT", "ATCT-A/C", "ATCT-RAPCON", "ATCT-RATCF", "ATCT-TRACON" }) &&
+//     Predicate::AtLeast("ELEV", 4000.0) &&
+//     Predicate::Any(SourceFile::APT_RWY, Predicate::In("SURFACE_TYPE_CODE", { "ASPH", "CONC" }) && Predicate::AtLeast("RWY_LEN", 5000.0))
+//
+// Comparisons never match null values; ! is the complement of the rows it
+// negates, so it does match them.
+class Predicate
+{
+public:
+    enum class Operation
+    {
+        IN,
+        BETWEEN,
+        IS_NULL,
+        ANY,
+        AND,
+        OR,
+        NOT
+    };
+
+    struct Node
+    {
+        Operation operation;
+        std::string column;
+        std::vector<std::string> values;    // IN
+        double minimum;                     // BETWEEN
+        double maximum;
+        SourceFile file;                    // ANY
+        std::vector<Predicate> children;    // ANY, AND, OR and NOT
+    };
+
+    static Predicate Equals(const std::string& column, const std::string& value);
+    static Predicate In(const std::string& column, const std::vector<std::string>& values);
+    static Predicate Between(const std::string& column, double minimum, double maximum);
+    static Predicate AtLeast(const std::string& column, double minimum);
+    static Predicate AtMost(const std::string& column, double maximum);
+    static Predicate IsNull(const std::string& column);
+
+    // rows sharing their ARPT_ID with at least one row of file matching the predicate
+    static Predicate Any(SourceFile file, const Predicate& predicate);
+
+    Predicate operator&&(const Predicate& other) const;
+    Predicate operator||(const Predicate& other) const;
+    Predicate operator!() const;
+
+    const Node& getNode() const;
+
+private:
+    Predicate(Node node);
+
+private:
+    std::shared_ptr<const Node> _node;
+};
+
+// ----------------------------------------------------------------------------
+
+enum class AggregateFunction
+{
+    COUNT,
+    SUM,
+    MINIMUM,
+    MAXIMUM,
+    AVERAGE
+};
+
+// ----------------------------------------------------------------------------
+
+// one output value per group; several columns are added together per row,
+// e.g. { AggregateFunction::SUM, { "COMMERCIAL_OPS", "LOCAL_OPS" } }, and the
+// row counts as null when all of them are.  Nulls are skipped, so COUNT counts
+// non-null rows (every row when no column is given) and the other functions
+// have no value for groups without a non-null row.
+struct Aggregation
+{
+    AggregateFunction function;
+    std::vector<std::string> columns;
+};
+
+// ----------------------------------------------------------------------------
+
+struct AggregateGroup
+{
+    std::vector<std::string> key;               // one value per group-by column, empty for null
+    size_t rowCount;
+    std::vector<tl::optional<double>> values;   // one per aggregation
+};
+
+// ----------------------------------------------------------------------------
+
+// Evaluates predicates over the twelve files, indexed by SourceFile, in
+// blocks of rows narrowed through selection vectors.  Blocks are spread
+// across threads and decoded columns are cached between queries; copies of
+// an engine share that cache.  Files referenced through Predicate::Any are
+// joined on ARPT_ID, so the file being selected needs an index on it.
+class QueryEngine
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 1024;
+
+    QueryEngine();
+
+    std::vector<size_t> select(const std::vector<const CSV::File*>& files, SourceFile file, const Predicate& predicate, size_t threads = 0) const;
+
+    // groups of the rows (matching the predicate) by the values of the group-by columns, in
+    // ascending key order with null keys last; rows are folded into per-thread hash tables
+    // that are merged at the end
+    std::vector<AggregateGroup> aggregate(const std::vector<const CSV::File*>& files, SourceFile file, const std::vector<std::string>& groupBy, const std::vector<Aggregation>& aggregations, size_t threads = 0) const;
+    std::vector<AggregateGroup> aggregate(const std::vector<const CSV::File*>& files, SourceFile file, const Predicate& predicate, const std::vector<std::string>& groupBy, const std::vector<Aggregation>& aggregations, size_t threads = 0) const;
+
+    // decoded column of a file; throws std::out_of_range for unknown columns
+    std::shared_ptr<const TypedColumn> getColumn(const std::vector<const CSV::File*>& files, SourceFile file, const std::string& name) const;
+
+private:
+    std::vector<AggregateGroup> aggregateRows(const std::vector<const CSV::File*>& files, SourceFile file, const std::vector<size_t>* rows, const std::vector<std::string>& groupBy, const std::vector<Aggregation>& aggregations, size_t threads) const;
+
+private:
+    struct Cache
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const TypedColumn>> columns[SOURCE_FILE_COUNT];
+    };
+
+private:
+    std::shared_ptr<Cache> _cache;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
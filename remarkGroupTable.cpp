@@ -0,0 +1,226 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "remarkGroupTable.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+struct RemarkKey
+{
+    uint32_t airport;
+    uint32_t table;
+    uint32_t element;
+    uint32_t column;
+    long sequence;
+    uint32_t row;
+};
+
+// ----------------------------------------------------------------------------
+
+bool operator<(const RemarkKey &a, const RemarkKey &b)
+{
+    if (a.airport != b.airport) return a.airport < b.airport;
+    if (a.table != b.table) return a.table < b.table;
+    if (a.element != b.element) return a.element < b.element;
+    if (a.column != b.column) return a.column < b.column;
+    if (a.sequence != b.sequence) return a.sequence < b.sequence;
+    return a.row < b.row;
+}
+
+// ----------------------------------------------------------------------------
+
+// compares the first depth fields of table, element and column
+template <typename TGroup>
+bool GroupLess(const TGroup &a, const TGroup &b, size_t depth)
+{
+    if (a.table != b.table) return a.table < b.table;
+    if (depth > 1 && a.element != b.element) return a.element < b.element;
+    if (depth > 2 && a.column != b.column) return a.column < b.column;
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+RemarkGroupTable::RemarkGroupTable()
+    : _airportOffsets(1, 0),
+      _groups(1, Group{ 0, 0, 0, 0 })
+{
+}
+
+// ----------------------------------------------------------------------------
+
+RemarkGroupTable::RemarkGroupTable(const CSV::File &remarks)
+{
+    const CSV::Column airports = remarks.getColumn("ARPT_ID");
+    const CSV::Column tables = remarks.getColumn("TAB_NAME");
+    const CSV::Column elements = remarks.getColumn("ELEMENT");
+    const CSV::Column columns = remarks.getColumn("REF_COL_NAME");
+    const CSV::Column sequences = remarks.getColumn("REF_COL_SEQ_NO");
+    const size_t count = airports.get().size();
+
+    // element and column names share one pool whose ids follow string order
+    _strings = elements.get();
+    _strings.insert(_strings.end(), columns.get().begin(), columns.get().end());
+    std::sort(_strings.begin(), _strings.end());
+    _strings.erase(std::unique(_strings.begin(), _strings.end()), _strings.end());
+    _stringIds.reserve(_strings.size());
+    for (size_t id = 0; id < _strings.size(); id++)
+    {
+        _stringIds.emplace(_strings[id], static_cast<uint32_t>(id));
+    }
+
+    std::vector<Detail::RemarkKey> keys(count);
+    for (size_t row = 0; row < count; row++)
+    {
+        const uint32_t airport = _airports.emplace(airports.get()[row], static_cast<uint32_t>(_airports.size())).first->second;
+        keys[row].airport = airport;
+        keys[row].table = static_cast<uint32_t>(APT::ParsableRemarksTable(tables.get()[row]).value());
+        keys[row].element = _stringIds.at(elements.get()[row]);
+        keys[row].column = _stringIds.at(columns.get()[row]);
+        keys[row].sequence = std::strtol(sequences.get()[row].c_str(), nullptr, 10);
+        keys[row].row = static_cast<uint32_t>(row);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    _rows.resize(count);
+    _airportOffsets.assign(_airports.size() + 1, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Detail::RemarkKey &key = keys[i];
+        _rows[i] = key.row;
+        const bool newAirport = i == 0 || key.airport != keys[i - 1].airport;
+        if (newAirport || key.table != keys[i - 1].table || key.element != keys[i - 1].element || key.column != keys[i - 1].column)
+        {
+            _groups.push_back({ key.table, key.element, key.column, static_cast<uint32_t>(i) });
+        }
+        _airportOffsets[key.airport + 1] = static_cast<uint32_t>(_groups.size());
+    }
+    _groups.push_back({ 0, 0, 0, static_cast<uint32_t>(count) });
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RemarkGroupTable::getGroupCount() const
+{
+    return _groups.size() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan RemarkGroupTable::getRemarkRows(const std::string &airportIdentifier) const
+{
+    return find(airportIdentifier, Group{ 0, 0, 0, 0 }, 0);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan RemarkGroupTable::getRemarkRows(const std::string &airportIdentifier, APT::RemarksTable table) const
+{
+    return find(airportIdentifier, Group{ static_cast<uint32_t>(table), 0, 0, 0 }, 1);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan RemarkGroupTable::getRemarkRows(const std::string &airportIdentifier, APT::RemarksTable table, const std::string &element) const
+{
+    const tl::optional<uint32_t> elementId = findString(element);
+    if (!elementId)
+    {
+        return CSV::RowSpan();
+    }
+    return find(airportIdentifier, Group{ static_cast<uint32_t>(table), *elementId, 0, 0 }, 2);
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan RemarkGroupTable::getRemarkRows(const std::string &airportIdentifier, APT::RemarksTable table, const std::string &element, const std::string &column) const
+{
+    const tl::optional<uint32_t> elementId = findString(element);
+    const tl::optional<uint32_t> columnId = findString(column);
+    if (!elementId || !columnId)
+    {
+        return CSV::RowSpan();
+    }
+    return find(airportIdentifier, Group{ static_cast<uint32_t>(table), *elementId, *columnId, 0 }, 3);
+}
+
+// ----------------------------------------------------------------------------
+
+tl::optional<uint32_t> RemarkGroupTable::findString(const std::string &value) const
+{
+    std::unordered_map<std::string, uint32_t>::const_iterator search = _stringIds.find(value);
+    if (search == _stringIds.end())
+    {
+        return tl::nullopt;
+    }
+    return search->second;
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan RemarkGroupTable::find(const std::string &airportIdentifier, const Group &key, size_t depth) const
+{
+    std::unordered_map<std::string, uint32_t>::const_iterator airport = _airports.find(airportIdentifier);
+    if (airport == _airports.end())
+    {
+        return CSV::RowSpan();
+    }
+
+    // groups of one airport are sorted by table, element and column, so the
+    // groups sharing a prefix of the key are adjacent and so are their rows
+    std::vector<Group>::const_iterator first = _groups.begin() + _airportOffsets[airport->second];
+    std::vector<Group>::const_iterator last = _groups.begin() + _airportOffsets[airport->second + 1];
+    if (depth > 0)
+    {
+        first = std::lower_bound(first, last, key, [depth](const Group &a, const Group &b) { return Detail::GroupLess(a, b, depth); });
+        last = std::upper_bound(first, last, key, [depth](const Group &a, const Group &b) { return Detail::GroupLess(a, b, depth); });
+    }
+    return CSV::RowSpan(_rows.data() + first->begin, _rows.data() + last->begin);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
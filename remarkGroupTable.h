@@ -0,0 +1,90 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "airportRemarksEntry.h"
+#include "csv.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// Load-time grouping of APT_RMK rows by (ARPT_ID, TAB_NAME, ELEMENT,
+// REF_COL_NAME), each group ordered by REF_COL_SEQ_NO.  Rows are stored
+// once in that order, so the remarks of an airport, of one of its tables,
+// of one element of a table or of one column of an element are each a
+// contiguous RowSpan found by a hash probe and a binary search.
+class RemarkGroupTable
+{
+public:
+    RemarkGroupTable();
+    RemarkGroupTable(const CSV::File& remarks);
+
+    size_t getGroupCount() const;
+
+    // rows of an airport, narrowed by table, ELEMENT and REF_COL_NAME, e.g.
+    // getRemarkRows("SFO", APT::RemarksTable::RUNWAY_END, "10L/28R/28R")
+    CSV::RowSpan getRemarkRows(const std::string& airportIdentifier) const;
+    CSV::RowSpan getRemarkRows(const std::string& airportIdentifier, APT::RemarksTable table) const;
+    CSV::RowSpan getRemarkRows(const std::string& airportIdentifier, APT::RemarksTable table, const std::string& element) const;
+    CSV::RowSpan getRemarkRows(const std::string& airportIdentifier, APT::RemarksTable table, const std::string& element, const std::string& column) const;
+
+private:
+    struct Group
+    {
+        uint32_t table;
+        uint32_t element;       // into _strings, ids follow string order
+        uint32_t column;        // into _strings
+        uint32_t begin;         // into _rows; the group ends where the next one begins
+    };
+
+    tl::optional<uint32_t> findString(const std::string& value) const;
+    CSV::RowSpan find(const std::string& airportIdentifier, const Group& key, size_t depth) const;
+
+private:
+    std::vector<std::string> _strings;
+    std::unordered_map<std::string, uint32_t> _stringIds;
+    std::unordered_map<std::string, uint32_t> _airports;   // ARPT_ID to index into _airportOffsets
+    std::vector<uint32_t> _airportOffsets;                  // airports + 1 entries into _groups
+    std::vector<Group> _groups;                             // plus a sentinel beginning at _rows.size()
+    std::vector<uint32_t> _rows;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
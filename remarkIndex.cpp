@@ -0,0 +1,299 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "remarkIndex.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <unordered_map>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+RemarkIndex::RemarkIndex()
+    : _rows(0), _offsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+RemarkIndex::RemarkIndex(const std::vector<std::string> &texts, size_t threads)
+    : _rows(texts.size())
+{
+    typedef std::unordered_map<std::string, std::vector<Posting>> PostingMap;
+
+    // each thread tokenizes a contiguous block of rows, so concatenating the
+    // per-thread lists in thread order keeps every posting list sorted
+    std::vector<PostingMap> partial(Parallel::GetThreadCount(threads));
+    Parallel::For(texts.size(), partial.size(), [&texts, &partial](size_t begin, size_t end, size_t thread)
+    {
+        PostingMap &local = partial[thread];
+        for (size_t row = begin; row < end; row++)
+        {
+            const std::vector<std::string> words = Tokenize(texts[row]);
+            for (size_t position = 0; position < words.size(); position++)
+            {
+                local[words[position]].push_back({ static_cast<uint32_t>(row), static_cast<uint32_t>(position) });
+            }
+        }
+    });
+
+    for (const PostingMap &local : partial)
+    {
+        for (const PostingMap::value_type &entry : local)
+        {
+            _terms.push_back(entry.first);
+        }
+    }
+    std::sort(_terms.begin(), _terms.end());
+    _terms.erase(std::unique(_terms.begin(), _terms.end()), _terms.end());
+
+    _offsets.reserve(_terms.size() + 1);
+    _offsets.push_back(0);
+    for (const std::string &term : _terms)
+    {
+        for (const PostingMap &local : partial)
+        {
+            PostingMap::const_iterator search = local.find(term);
+            if (search != local.end())
+            {
+                _postings.insert(_postings.end(), search->second.begin(), search->second.end());
+            }
+        }
+        _offsets.push_back(static_cast<uint32_t>(_postings.size()));
+    }
+    _postings.shrink_to_fit();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RemarkIndex::size() const
+{
+    return _rows;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RemarkIndex::getTermCount() const
+{
+    return _terms.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RemarkIndex::getMemoryUsage() const
+{
+    size_t out = _offsets.capacity() * sizeof(uint32_t) + _postings.capacity() * sizeof(Posting);
+    for (const std::string &term : _terms)
+    {
+        out += sizeof(std::string) + term.capacity();
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::string> RemarkIndex::Tokenize(const std::string &text)
+{
+    std::vector<std::string> out;
+    std::string word;
+    for (char c : text)
+    {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u))
+        {
+            word.push_back(static_cast<char>(std::toupper(u)));
+        }
+        else if (!word.empty())
+        {
+            out.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.empty())
+    {
+        out.push_back(word);
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+bool RemarkIndex::findTerm(const std::string &term, size_t &begin, size_t &end) const
+{
+    std::vector<std::string>::const_iterator search = std::lower_bound(_terms.begin(), _terms.end(), term);
+    if (search == _terms.end() || *search != term)
+    {
+        return false;
+    }
+    const size_t index = search - _terms.begin();
+    begin = _offsets[index];
+    end = _offsets[index + 1];
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> RemarkIndex::matchPhrase(const std::vector<std::string> &terms) const
+{
+    std::vector<size_t> out;
+
+    // (row, position) pairs at which the phrase could start, narrowed term by term
+    std::vector<uint64_t> starts;
+    std::vector<uint64_t> next;
+    std::vector<uint64_t> merged;
+    for (size_t i = 0; i < terms.size(); i++)
+    {
+        size_t begin = 0;
+        size_t end = 0;
+        if (!findTerm(terms[i], begin, end))
+        {
+            return out;
+        }
+
+        std::vector<uint64_t> &target = i == 0 ? starts : next;
+        target.clear();
+        for (size_t posting = begin; posting < end; posting++)
+        {
+            if (_postings[posting].position >= i)
+            {
+                target.push_back((static_cast<uint64_t>(_postings[posting].row) << 32) | (_postings[posting].position - i));
+            }
+        }
+        if (i != 0)
+        {
+            merged.clear();
+            std::set_intersection(starts.begin(), starts.end(), next.begin(), next.end(), std::back_inserter(merged));
+            starts.swap(merged);
+        }
+        if (starts.empty())
+        {
+            return out;
+        }
+    }
+
+    for (uint64_t start : starts)
+    {
+        const size_t row = static_cast<size_t>(start >> 32);
+        if (out.empty() || out.back() != row)
+        {
+            out.push_back(row);
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> RemarkIndex::search(const std::string &query) const
+{
+    // split into operands (phrases or words) and AND / OR operators; clauses
+    // holds the OR-separated groups of ANDed operands
+    std::vector<std::vector<std::vector<std::string>>> clauses(1);
+    size_t i = 0;
+    while (i < query.size())
+    {
+        if (std::isspace(static_cast<unsigned char>(query[i])))
+        {
+            i++;
+            continue;
+        }
+
+        size_t end = 0;
+        std::string operand;
+        if (query[i] == '"')
+        {
+            end = query.find('"', i + 1);
+            end = end == std::string::npos ? query.size() : end;
+            operand = query.substr(i + 1, end - i - 1);
+            i = std::min(query.size(), end + 1);
+        }
+        else
+        {
+            end = i;
+            while (end < query.size() && !std::isspace(static_cast<unsigned char>(query[end])) && query[end] != '"')
+            {
+                end++;
+            }
+            operand = query.substr(i, end - i);
+            i = end;
+
+            if (operand == "OR")
+            {
+                clauses.emplace_back();
+                continue;
+            }
+            if (operand == "AND")
+            {
+                continue;
+            }
+        }
+
+        // punctuation inside a word, as in RWY-28, splits it into a phrase
+        std::vector<std::string> terms = Tokenize(operand);
+        if (!terms.empty())
+        {
+            clauses.back().push_back(terms);
+        }
+    }
+
+    std::vector<size_t> out;
+    std::vector<size_t> merged;
+    for (const std::vector<std::vector<std::string>> &clause : clauses)
+    {
+        if (clause.empty())
+        {
+            continue;
+        }
+
+        std::vector<size_t> rows = matchPhrase(clause[0]);
+        for (size_t operand = 1; operand < clause.size() && !rows.empty(); operand++)
+        {
+            const std::vector<size_t> other = matchPhrase(clause[operand]);
+            merged.clear();
+            std::set_intersection(rows.begin(), rows.end(), other.begin(), other.end(), std::back_inserter(merged));
+            rows.swap(merged);
+        }
+
+        merged.clear();
+        std::set_union(out.begin(), out.end(), rows.begin(), rows.end(), std::back_inserter(merged));
+        out.swap(merged);
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,84 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// Inverted index over free-text remarks.  Text is split into upper-case
+// alphanumeric words and each word keeps the rows and word positions it
+// occurs at, which allows phrase queries as well as boolean combinations.
+//
+// Query syntax: words and "quoted phrases" separated by AND / OR, where AND
+// binds tighter than OR and adjacent terms are implicitly ANDed, for example
+//     PPR OR "PRIOR PERMISSION" AND DEER
+class RemarkIndex
+{
+public:
+    RemarkIndex();
+    RemarkIndex(const std::vector<std::string>& texts, size_t threads = 0);
+
+    size_t size() const;
+    size_t getTermCount() const;
+    size_t getMemoryUsage() const;
+
+    // matching rows in ascending order
+    std::vector<size_t> search(const std::string& query) const;
+
+    static std::vector<std::string> Tokenize(const std::string& text);
+
+private:
+    struct Posting
+    {
+        uint32_t row;
+        uint32_t position; // word offset within the row's text
+    };
+
+    std::vector<size_t> matchPhrase(const std::vector<std::string>& terms) const;
+    bool findTerm(const std::string& term, size_t& begin, size_t& end) const;
+
+private:
+    size_t _rows;
+    std::vector<std::string> _terms;    // sorted
+    std::vector<uint32_t> _offsets;     // _terms.size() + 1 entries into _postings
+    std::vector<Posting> _postings;     // sorted by row then position within each term
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -43,6 +43,29 @@ namespace APT
 
 // ----------------------------------------------------------------------------
 
+bool IsPavedSurface(SurfaceType type)
+{
+    switch (type)
+    {
+    case SurfaceType::PORTLAND_CEMENT_CONCRETE:
+    case SurfaceType::ASPHALT_OR_BITUMINOUS_CONCRETE:
+    case SurfaceType::PARTIALLY_CONCRETE_OR_ASPHALT_OR_BITUMEN_OR_BOUND_MACADAM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool IsPavedSurfaceCode(const std::string &surfaceTypeCode)
+{
+    const std::string primary = surfaceTypeCode.substr(0, surfaceTypeCode.find_first_of("-/ "));
+    return IsPavedSurface(ParsableSurfaceType(primary).value());
+}
+
+// ----------------------------------------------------------------------------
+
 const std::string &RunwayEntry::getRwyId() const
 {
     return _data["RWY_ID"];
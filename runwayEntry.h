@@ -118,6 +118,11 @@ const std::unordered_map<std::string, SurfaceType> SurfaceTypeLookup
 
 typedef CSV::ParsableEnum<SurfaceType, SurfaceTypeLookup, SurfaceType::UNKNOWN> ParsableSurfaceType;
 
+bool IsPavedSurface(SurfaceType type);
+
+// checks the primary surface of a raw SURFACE_TYPE_CODE value (e.g. "ASPH-GRVL")
+bool IsPavedSurfaceCode(const std::string& surfaceTypeCode);
+
 // ----------------------------------------------------------------------------
 
 enum class SurfaceCondition
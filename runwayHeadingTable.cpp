@@ -0,0 +1,184 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "runwayHeadingTable.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+// east positive degrees from a magnitude column and an "E"/"W" hemisphere column
+std::vector<float> ParseVariations(const CSV::File &file, const std::string &magnitudeColumn, const std::string &hemisphereColumn)
+{
+    const CSV::Column magnitudes = file.getColumn(magnitudeColumn);
+    const CSV::Column hemispheres = file.getColumn(hemisphereColumn);
+    std::vector<float> out(magnitudes.get().size(), std::numeric_limits<float>::quiet_NaN());
+    for (size_t row = 0; row < out.size(); row++)
+    {
+        const tl::optional<double> magnitude = CSV::Utils::ParseOptional<double>(magnitudes.get()[row]);
+        const std::string &hemisphere = hemispheres.get()[row];
+        if (magnitude && (hemisphere == "E" || hemisphere == "W"))
+        {
+            out[row] = static_cast<float>(hemisphere == "W" ? -*magnitude : *magnitude);
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+float NormalizeHeading(float heading)
+{
+    const float normalized = std::fmod(heading, 360.0f);
+    return normalized < 0.0f ? normalized + 360.0f : normalized;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+RunwayHeadingTable::RunwayHeadingTable()
+{
+}
+
+// ----------------------------------------------------------------------------
+
+RunwayHeadingTable::RunwayHeadingTable(const RunwayJoinTable &join, const RunwayWindTable &wind, const CSV::File &base, const CSV::File &ilsBase, const ILSSystemTable &ils)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    if (base.isValid())
+    {
+        _airportVariations = Detail::ParseVariations(base, "MAG_VARN", "MAG_HEMIS");
+    }
+    _trueHeadings.assign(join.size(), nan);
+    _magneticHeadings.assign(join.size(), nan);
+    _approachBearings.assign(join.size(), nan);
+    _ilsVariations.assign(join.size(), nan);
+
+    const std::vector<uint32_t> &airportRows = join.getAirportRows();
+    for (size_t end = 0; end < wind.size(); end++)
+    {
+        const uint32_t id = join.getId(wind.getRunwayEndRow(end));
+        if (id == RunwayJoinTable::NO_ROW)
+        {
+            continue;
+        }
+
+        // NaN propagates when the airport's variation is unknown
+        const uint32_t airport = airportRows[id];
+        const float variation = airport < _airportVariations.size() ? _airportVariations[airport] : nan;
+        _trueHeadings[id] = wind.getHeading(end);
+        _magneticHeadings[id] = Detail::NormalizeHeading(wind.getHeading(end) - variation);
+    }
+
+    if (!ilsBase.isValid())
+    {
+        return;
+    }
+    const CSV::Column bearings = ilsBase.getColumn("APCH_BEAR");
+    const std::vector<float> ilsVariations = Detail::ParseVariations(ilsBase, "MAG_VAR", "MAG_VAR_HEMIS");
+    const std::vector<uint32_t> &runwayEndRows = join.getRunwayEndRows();
+    for (size_t id = 0; id < join.size(); id++)
+    {
+        if (runwayEndRows[id] == RunwayJoinTable::NO_ROW)
+        {
+            continue;
+        }
+        const CSV::RowSpan systems = ils.getSystemsForRunwayEnd(runwayEndRows[id]);
+        if (systems.empty())
+        {
+            continue;
+        }
+
+        const uint32_t localizer = ils.getSystem(systems[0]).localizerRow;
+        const tl::optional<double> bearing = CSV::Utils::ParseOptional<double>(bearings.get()[localizer]);
+        _approachBearings[id] = bearing ? Detail::NormalizeHeading(static_cast<float>(*bearing)) : nan;
+        _ilsVariations[id] = ilsVariations[localizer];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayHeadingTable::size() const
+{
+    return _trueHeadings.size();
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayHeadingTable::getMagneticVariations() const
+{
+    return _airportVariations;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayHeadingTable::getTrueHeadings() const
+{
+    return _trueHeadings;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayHeadingTable::getMagneticHeadings() const
+{
+    return _magneticHeadings;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayHeadingTable::getApproachBearings() const
+{
+    return _approachBearings;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayHeadingTable::getILSVariations() const
+{
+    return _ilsVariations;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,80 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+#include "ilsSystemTable.h"
+#include "runwayJoinTable.h"
+#include "runwayWindTable.h"
+
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// Headings of every runway end as columns indexed by RunwayJoinTable ID, plus
+// the magnetic variation of every airport indexed by APT_BASE row.  Variations
+// are degrees east positive and headings degrees in [0, 360); values that
+// cannot be derived are NaN.  True headings come from the RunwayWindTable (so
+// ends without a TRUE_ALIGNMENT use their designator corrected by the airport's
+// variation), and a magnetic heading is the true heading less the airport's
+// variation.  Ends served by an ILS carry the localizer's APCH_BEAR and MAG_VAR
+// (the first system listed when there are several).
+class RunwayHeadingTable
+{
+public:
+    RunwayHeadingTable();
+    RunwayHeadingTable(const RunwayJoinTable& join, const RunwayWindTable& wind, const CSV::File& base, const CSV::File& ilsBase, const ILSSystemTable& ils);
+
+    size_t size() const;
+
+    const std::vector<float>& getMagneticVariations() const;   // per APT_BASE row
+
+    // columns indexed by RunwayJoinTable ID
+    const std::vector<float>& getTrueHeadings() const;
+    const std::vector<float>& getMagneticHeadings() const;
+    const std::vector<float>& getApproachBearings() const;     // ILS APCH_BEAR, magnetic
+    const std::vector<float>& getILSVariations() const;        // ILS MAG_VAR
+
+private:
+    std::vector<float> _airportVariations;
+    std::vector<float> _trueHeadings;
+    std::vector<float> _magneticHeadings;
+    std::vector<float> _approachBearings;
+    std::vector<float> _ilsVariations;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,258 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "runwayJoinTable.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr uint32_t RunwayJoinTable::NO_ROW;
+
+const std::vector<std::string> RunwayJoinTable::RUNWAY_KEY{ "ARPT_ID", "RWY_ID" };
+const std::vector<std::string> RunwayJoinTable::RUNWAY_END_KEY{ "ARPT_ID", "RWY_ID", "RWY_END_ID" };
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+std::vector<float> ParseFloats(const CSV::Column &column)
+{
+    std::vector<float> out;
+    out.reserve(column.get().size());
+    for (const std::string &value : column.get())
+    {
+        const tl::optional<double> parsed = value.empty() ? tl::nullopt : CSV::Utils::ParseOptional<double>(value);
+        out.push_back(parsed ? static_cast<float>(*parsed) : std::numeric_limits<float>::quiet_NaN());
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+RunwayJoinTable::RunwayJoinTable()
+    : _airportOffsets(1, 0),
+      _arrestingOffsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+RunwayJoinTable::RunwayJoinTable(const CSV::File &base, const CSV::File &runways, const CSV::File &runwayEnds, const CSV::File &arresting, size_t threads)
+    : RunwayJoinTable()
+{
+    if (!base.isValid() || !runways.isValid() || !runwayEnds.isValid())
+    {
+        return;
+    }
+
+    const size_t airportCount = base.getColumn("ARPT_ID").get().size();
+    const CSV::Column airports = runwayEnds.getColumn("ARPT_ID");
+    const CSV::Column runwayIdentifiers = runwayEnds.getColumn("RWY_ID");
+    const CSV::Column endIdentifiers = runwayEnds.getColumn("RWY_END_ID");
+    const size_t count = airports.get().size();
+
+    // resolve every runway end in parallel; the hash indexes are read-only
+    struct Match
+    {
+        uint32_t airportRow;
+        uint32_t runwayRow;
+        uint32_t endRow;
+        CSV::RowSpan arresting;
+    };
+    std::vector<Match> matches(count);
+    Parallel::For(count, threads, [&](size_t begin, size_t end, size_t)
+    {
+        std::vector<std::string> key(3);
+        for (size_t row = begin; row < end; row++)
+        {
+            key[0] = airports.get()[row];
+            key[1] = runwayIdentifiers.get()[row];
+            key[2] = endIdentifiers.get()[row];
+
+            const CSV::RowSpan airport = base.lookup("ARPT_ID", key[0]);
+            const CSV::RowSpan runway = runways.lookupComposite(RUNWAY_KEY, { key[0], key[1] });
+            matches[row].airportRow = airport.empty() ? NO_ROW : airport[0];
+            matches[row].runwayRow = runway.empty() ? NO_ROW : runway[0];
+            matches[row].endRow = static_cast<uint32_t>(row);
+            matches[row].arresting = arresting.isValid() ? arresting.lookupComposite(RUNWAY_END_KEY, key) : CSV::RowSpan();
+        }
+    });
+    std::sort(matches.begin(), matches.end(), [](const Match &a, const Match &b)
+    {
+        if (a.airportRow != b.airportRow) return a.airportRow < b.airportRow;
+        if (a.runwayRow != b.runwayRow) return a.runwayRow < b.runwayRow;
+        return a.endRow < b.endRow;
+    });
+
+    const std::vector<float> lengths = Detail::ParseFloats(runways.getColumn("RWY_LEN"));
+    const std::vector<float> widths = Detail::ParseFloats(runways.getColumn("RWY_WIDTH"));
+
+    _ids.assign(count, NO_ROW);
+    _airportOffsets.assign(airportCount + 1, 0);
+    _airportRows.reserve(count);
+    _runwayRows.reserve(count);
+    _runwayEndRows.reserve(count);
+    _lengths.reserve(count);
+    _widths.reserve(count);
+    _arrestingOffsets.reserve(count + 1);
+    for (size_t id = 0; id < count; id++)
+    {
+        const Match &match = matches[id];
+        _ids[match.endRow] = static_cast<uint32_t>(id);
+        _airportRows.push_back(match.airportRow);
+        _runwayRows.push_back(match.runwayRow);
+        _runwayEndRows.push_back(match.endRow);
+        _lengths.push_back(match.runwayRow != NO_ROW ? lengths[match.runwayRow] : std::numeric_limits<float>::quiet_NaN());
+        _widths.push_back(match.runwayRow != NO_ROW ? widths[match.runwayRow] : std::numeric_limits<float>::quiet_NaN());
+        _arrestingRows.insert(_arrestingRows.end(), match.arresting.begin(), match.arresting.end());
+        _arrestingOffsets.push_back(static_cast<uint32_t>(_arrestingRows.size()));
+        if (match.airportRow != NO_ROW)
+        {
+            _airportOffsets[match.airportRow + 1]++;
+        }
+    }
+    for (size_t airport = 0; airport < airportCount; airport++)
+    {
+        _airportOffsets[airport + 1] += _airportOffsets[airport];
+    }
+
+    // a runway with exactly two matched ends pairs them
+    _oppositeEnds.assign(count, NO_ROW);
+    for (size_t first = 0; first < count;)
+    {
+        size_t last = first + 1;
+        while (last < count && _runwayRows[last] == _runwayRows[first] && _airportRows[last] == _airportRows[first])
+        {
+            last++;
+        }
+        if (last - first == 2 && _runwayRows[first] != NO_ROW)
+        {
+            _oppositeEnds[first] = static_cast<uint32_t>(first + 1);
+            _oppositeEnds[first + 1] = static_cast<uint32_t>(first);
+        }
+        first = last;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayJoinTable::size() const
+{
+    return _runwayEndRows.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayJoinTable::getFirstEnd(size_t airportRow) const
+{
+    return airportRow + 1 < _airportOffsets.size() ? _airportOffsets[airportRow] : 0;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayJoinTable::getEndCount(size_t airportRow) const
+{
+    return airportRow + 1 < _airportOffsets.size() ? _airportOffsets[airportRow + 1] - _airportOffsets[airportRow] : 0;
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t RunwayJoinTable::getId(size_t runwayEndRow) const
+{
+    return runwayEndRow < _ids.size() ? _ids[runwayEndRow] : NO_ROW;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &RunwayJoinTable::getAirportRows() const
+{
+    return _airportRows;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &RunwayJoinTable::getRunwayRows() const
+{
+    return _runwayRows;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &RunwayJoinTable::getRunwayEndRows() const
+{
+    return _runwayEndRows;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<uint32_t> &RunwayJoinTable::getOppositeEnds() const
+{
+    return _oppositeEnds;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayJoinTable::getRunwayLengths() const
+{
+    return _lengths;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<float> &RunwayJoinTable::getRunwayWidths() const
+{
+    return _widths;
+}
+
+// ----------------------------------------------------------------------------
+
+CSV::RowSpan RunwayJoinTable::getArrestingRows(size_t id) const
+{
+    return CSV::RowSpan(_arrestingRows.data() + _arrestingOffsets[id], _arrestingRows.data() + _arrestingOffsets[id + 1]);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,97 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// Load-time join of APT_BASE, APT_RWY, APT_RWY_END and APT_ARS with one
+// entry per runway end.  Entries are ordered by airport row, runway row and
+// runway end row, and an entry's position is its ID, so the ends of an
+// airport (and the two ends of a runway) are contiguous and a scan over all
+// runway ends with their runway and airport is a walk down parallel arrays.
+// Runway ends are matched to runways on RUNWAY_KEY and arresting gear to
+// runway ends on RUNWAY_END_KEY, through hash indexes the files must declare;
+// airports are matched through the ARPT_ID index.
+class RunwayJoinTable
+{
+public:
+    static constexpr uint32_t NO_ROW = 0xFFFFFFFF;
+    static const std::vector<std::string> RUNWAY_KEY;
+    static const std::vector<std::string> RUNWAY_END_KEY;
+
+    RunwayJoinTable();
+    RunwayJoinTable(const CSV::File& base, const CSV::File& runways, const CSV::File& runwayEnds, const CSV::File& arresting, size_t threads = 0);
+
+    size_t size() const;
+
+    // entries of an APT_BASE row as [getFirstEnd(airport), getFirstEnd(airport) + getEndCount(airport))
+    size_t getFirstEnd(size_t airportRow) const;
+    size_t getEndCount(size_t airportRow) const;
+
+    // ID of the entry for an APT_RWY_END row, NO_ROW when the row is unknown
+    uint32_t getId(size_t runwayEndRow) const;
+
+    // columns indexed by ID; rows that could not be matched hold NO_ROW
+    const std::vector<uint32_t>& getAirportRows() const;       // APT_BASE
+    const std::vector<uint32_t>& getRunwayRows() const;        // APT_RWY
+    const std::vector<uint32_t>& getRunwayEndRows() const;     // APT_RWY_END
+    const std::vector<uint32_t>& getOppositeEnds() const;      // ID of the other end of the runway
+    const std::vector<float>& getRunwayLengths() const;        // feet, NaN when unknown
+    const std::vector<float>& getRunwayWidths() const;         // feet, NaN when unknown
+
+    CSV::RowSpan getArrestingRows(size_t id) const;            // APT_ARS
+
+private:
+    std::vector<uint32_t> _airportOffsets;  // APT_BASE rows + 1 entries
+    std::vector<uint32_t> _ids;             // per APT_RWY_END row
+    std::vector<uint32_t> _airportRows;
+    std::vector<uint32_t> _runwayRows;
+    std::vector<uint32_t> _runwayEndRows;
+    std::vector<uint32_t> _oppositeEnds;
+    std::vector<float> _lengths;
+    std::vector<float> _widths;
+    std::vector<uint32_t> _arrestingOffsets;    // entries + 1 entries into _arrestingRows
+    std::vector<uint32_t> _arrestingRows;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
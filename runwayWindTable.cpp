@@ -0,0 +1,331 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "runwayWindTable.h"
+#include "geo.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+std::string RunwayKey(const std::string &airport, const std::string &runway)
+{
+    return airport + '\x1f' + runway;
+}
+
+// ----------------------------------------------------------------------------
+
+// magnetic heading implied by a designator such as "09" or "28L"
+tl::optional<double> DesignatorHeading(const std::string &endIdentifier)
+{
+    size_t digits = 0;
+    while (digits < endIdentifier.size() && digits < 2 && std::isdigit(static_cast<unsigned char>(endIdentifier[digits])))
+    {
+        digits++;
+    }
+    if (digits == 0)
+    {
+        return tl::nullopt;
+    }
+
+    const int designator = CSV::Utils::ParseNumber<int>(endIdentifier.substr(0, digits));
+    if (designator < 1 || designator > 36)
+    {
+        return tl::nullopt;
+    }
+    return designator * 10.0;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+RunwayWindTable::RunwayWindTable()
+    : _offsets(1, 0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+RunwayWindTable::RunwayWindTable(const CSV::File &base, const CSV::File &runways, const CSV::File &runwayEnds)
+    : _offsets(1, 0)
+{
+    if (!base.isValid() || !runways.isValid() || !runwayEnds.isValid())
+    {
+        return;
+    }
+
+    // airport rows and magnetic variation (east positive)
+    const std::vector<std::string> airportIdentifiers = base.getColumn("ARPT_ID").get();
+    const CSV::Column variations = base.getColumn("MAG_VARN");
+    const CSV::Column hemispheres = base.getColumn("MAG_HEMIS");
+    std::unordered_map<std::string, size_t> airportRows;
+    airportRows.reserve(airportIdentifiers.size());
+    for (size_t row = 0; row < airportIdentifiers.size(); row++)
+    {
+        airportRows.emplace(airportIdentifiers[row], row);
+    }
+
+    // runway lengths keyed on (ARPT_ID, RWY_ID)
+    const CSV::Column runwayAirports = runways.getColumn("ARPT_ID");
+    const CSV::Column runwayIdentifiers = runways.getColumn("RWY_ID");
+    const CSV::Column lengths = runways.getColumn("RWY_LEN");
+    std::unordered_map<std::string, float> runwayLengths;
+    runwayLengths.reserve(runwayAirports.get().size());
+    for (size_t row = 0; row < runwayAirports.get().size(); row++)
+    {
+        const tl::optional<int> length = CSV::Utils::ParseOptional<int>(lengths.get()[row]);
+        runwayLengths.emplace(Detail::RunwayKey(runwayAirports.get()[row], runwayIdentifiers.get()[row]), length ? static_cast<float>(*length) : 0.0f);
+    }
+
+    // collect usable ends, then group them by airport
+    const CSV::Column endAirports = runwayEnds.getColumn("ARPT_ID");
+    const CSV::Column endRunways = runwayEnds.getColumn("RWY_ID");
+    const CSV::Column endIdentifiers = runwayEnds.getColumn("RWY_END_ID");
+    const CSV::Column alignments = runwayEnds.getColumn("TRUE_ALIGNMENT");
+
+    struct Entry
+    {
+        uint32_t airport;
+        uint32_t row;
+        float heading;
+        float length;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(endAirports.get().size());
+    for (size_t row = 0; row < endAirports.get().size(); row++)
+    {
+        std::unordered_map<std::string, size_t>::const_iterator airport = airportRows.find(endAirports.get()[row]);
+        if (airport == airportRows.end())
+        {
+            continue;
+        }
+
+        tl::optional<double> heading = CSV::Utils::ParseOptional<double>(alignments.get()[row]);
+        if (!heading)
+        {
+            heading = Detail::DesignatorHeading(endIdentifiers.get()[row]);
+            const tl::optional<int> variation = CSV::Utils::ParseOptional<int>(variations.get()[airport->second]);
+            if (heading && variation)
+            {
+                const std::string &hemisphere = hemispheres.get()[airport->second];
+                *heading += (hemisphere == "W" ? -1.0 : 1.0) * *variation;
+            }
+        }
+        if (!heading)
+        {
+            continue;
+        }
+
+        std::unordered_map<std::string, float>::const_iterator length = runwayLengths.find(Detail::RunwayKey(endAirports.get()[row], endRunways.get()[row]));
+        entries.push_back({ static_cast<uint32_t>(airport->second), static_cast<uint32_t>(row), static_cast<float>(std::fmod(*heading + 360.0, 360.0)), length != runwayLengths.end() ? length->second : 0.0f });
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+    {
+        return a.airport < b.airport;
+    });
+
+    _offsets.assign(airportIdentifiers.size() + 1, 0);
+    _airport.reserve(entries.size());
+    _runwayEndRow.reserve(entries.size());
+    _heading.reserve(entries.size());
+    _cosHeading.reserve(entries.size());
+    _sinHeading.reserve(entries.size());
+    _length.reserve(entries.size());
+    _identifiers.reserve(entries.size());
+    for (const Entry &entry : entries)
+    {
+        _offsets[entry.airport + 1]++;
+        _airport.push_back(entry.airport);
+        _runwayEndRow.push_back(entry.row);
+        _heading.push_back(entry.heading);
+        _cosHeading.push_back(static_cast<float>(std::cos(Geo::ToRadians(entry.heading))));
+        _sinHeading.push_back(static_cast<float>(std::sin(Geo::ToRadians(entry.heading))));
+        _length.push_back(entry.length);
+        _identifiers.push_back(endIdentifiers.get()[entry.row]);
+    }
+    for (size_t airport = 0; airport < airportIdentifiers.size(); airport++)
+    {
+        _offsets[airport + 1] += _offsets[airport];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayWindTable::size() const
+{
+    return _heading.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayWindTable::getAirportCount() const
+{
+    return _offsets.size() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayWindTable::getFirstEnd(size_t airport) const
+{
+    return _offsets[airport];
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayWindTable::getEndCount(size_t airport) const
+{
+    return _offsets[airport + 1] - _offsets[airport];
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayWindTable::getAirport(size_t end) const
+{
+    return _airport[end];
+}
+
+// ----------------------------------------------------------------------------
+
+size_t RunwayWindTable::getRunwayEndRow(size_t end) const
+{
+    return _runwayEndRow[end];
+}
+
+// ----------------------------------------------------------------------------
+
+const std::string &RunwayWindTable::getRunwayEndIdentifier(size_t end) const
+{
+    return _identifiers[end];
+}
+
+// ----------------------------------------------------------------------------
+
+float RunwayWindTable::getHeading(size_t end) const
+{
+    return _heading[end];
+}
+
+// ----------------------------------------------------------------------------
+
+float RunwayWindTable::getLength(size_t end) const
+{
+    return _length[end];
+}
+
+// ----------------------------------------------------------------------------
+
+void RunwayWindTable::computeComponents(const Wind &wind, float *headwind, float *crosswind) const
+{
+    // headwind = speed * cos(wind - heading), crosswind = speed * sin(wind - heading),
+    // expanded so the loop is a handful of multiply-adds over packed floats
+    const float speedCos = static_cast<float>(wind.speed * std::cos(Geo::ToRadians(wind.direction)));
+    const float speedSin = static_cast<float>(wind.speed * std::sin(Geo::ToRadians(wind.direction)));
+    const float *cosHeading = _cosHeading.data();
+    const float *sinHeading = _sinHeading.data();
+    const size_t count = _cosHeading.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        headwind[i] = speedCos * cosHeading[i] + speedSin * sinHeading[i];
+        crosswind[i] = speedSin * cosHeading[i] - speedCos * sinHeading[i];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void RunwayWindTable::selectBest(const Wind &wind, float minimumLength, std::vector<RunwaySelection> &out) const
+{
+    const float speedCos = static_cast<float>(wind.speed * std::cos(Geo::ToRadians(wind.direction)));
+    const float speedSin = static_cast<float>(wind.speed * std::sin(Geo::ToRadians(wind.direction)));
+    out.resize(getAirportCount());
+    for (size_t airport = 0; airport < getAirportCount(); airport++)
+    {
+        out[airport] = selectBest(airport, speedCos, speedSin, minimumLength);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<RunwaySelection> RunwayWindTable::selectBest(const std::vector<size_t> &airports, const std::vector<Wind> &winds, float minimumLength) const
+{
+    std::vector<RunwaySelection> out;
+    out.reserve(airports.size());
+    for (size_t i = 0; i < airports.size(); i++)
+    {
+        const float speedCos = static_cast<float>(winds[i].speed * std::cos(Geo::ToRadians(winds[i].direction)));
+        const float speedSin = static_cast<float>(winds[i].speed * std::sin(Geo::ToRadians(winds[i].direction)));
+        out.push_back(selectBest(airports[i], speedCos, speedSin, minimumLength));
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+RunwaySelection RunwayWindTable::selectBest(size_t airport, float speedCos, float speedSin, float minimumLength) const
+{
+    RunwaySelection selection{ false, airport, 0, 0.0f, 0.0f };
+    if (airport >= getAirportCount())
+    {
+        return selection;
+    }
+
+    for (uint32_t end = _offsets[airport]; end < _offsets[airport + 1]; end++)
+    {
+        if (_length[end] < minimumLength)
+        {
+            continue;
+        }
+        const float headwind = speedCos * _cosHeading[end] + speedSin * _sinHeading[end];
+        if (!selection.found || headwind > selection.headwind || (headwind == selection.headwind && _length[end] > _length[selection.end]))
+        {
+            selection = { true, airport, end, headwind, speedSin * _cosHeading[end] - speedCos * _sinHeading[end] };
+        }
+    }
+    return selection;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
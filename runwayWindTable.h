@@ -0,0 +1,111 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+struct Wind
+{
+    double direction; // degrees true the wind is blowing from
+    double speed;     // knots
+};
+
+// ----------------------------------------------------------------------------
+
+struct RunwaySelection
+{
+    bool found;
+    size_t airport;   // APT_BASE row index
+    size_t end;       // index into the RunwayWindTable
+    float headwind;   // knots, negative for a tailwind
+    float crosswind;  // knots, positive when the wind is from the right
+};
+
+// ----------------------------------------------------------------------------
+
+// Packed table of every runway end's true heading and runway length, grouped
+// by airport so each airport's ends are contiguous.  Ends without a
+// TRUE_ALIGNMENT fall back to the runway designator corrected by the
+// airport's magnetic variation; ends with neither are left out.
+class RunwayWindTable
+{
+public:
+    RunwayWindTable();
+    RunwayWindTable(const CSV::File& base, const CSV::File& runways, const CSV::File& runwayEnds);
+
+    size_t size() const;
+    size_t getAirportCount() const;
+    size_t getFirstEnd(size_t airport) const;
+    size_t getEndCount(size_t airport) const;
+
+    size_t getAirport(size_t end) const;
+    size_t getRunwayEndRow(size_t end) const; // APT_RWY_END row index
+    const std::string& getRunwayEndIdentifier(size_t end) const;
+    float getHeading(size_t end) const;       // degrees true
+    float getLength(size_t end) const;        // feet, zero when unknown
+
+    // headwind and crosswind components for every end at once; both outputs must hold size() values
+    void computeComponents(const Wind& wind, float* headwind, float* crosswind) const;
+
+    // the end with the most headwind at each airport among runways at least minimumLength feet long,
+    // preferring the longer runway on ties; out is resized to getAirportCount()
+    void selectBest(const Wind& wind, float minimumLength, std::vector<RunwaySelection>& out) const;
+
+    // as above for a subset of airports, each with its own wind
+    std::vector<RunwaySelection> selectBest(const std::vector<size_t>& airports, const std::vector<Wind>& winds, float minimumLength) const;
+
+private:
+    RunwaySelection selectBest(size_t airport, float speedCos, float speedSin, float minimumLength) const;
+
+private:
+    std::vector<uint32_t> _offsets;     // per airport, CSR into the arrays below
+    std::vector<uint32_t> _airport;
+    std::vector<uint32_t> _runwayEndRow;
+    std::vector<float> _heading;
+    std::vector<float> _cosHeading;
+    std::vector<float> _sinHeading;
+    std::vector<float> _length;
+    std::vector<std::string> _identifiers;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,232 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "solarLightingTable.h"
+#include "airportBaseEntry.h"
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr uint8_t SolarLightingTable::RUNWAY_LIGHTS;
+constexpr uint8_t SolarLightingTable::BEACON_LIGHTS;
+constexpr size_t SolarLightingTable::CACHED_DAYS;
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+bool IsSunsetSunrise(const std::string &schedule)
+{
+    return APT::ParsableLightingSchedule(schedule).value() == APT::LightingSchedule::SUNSET_SUNRISE;
+}
+
+// ----------------------------------------------------------------------------
+
+// minutes folded into [-720, 720), i.e. relative to the nearest midnight-to-midnight cycle
+float WrapMinutes(float minutes)
+{
+    return minutes - 1440.0f * std::floor((minutes + 720.0f) / 1440.0f);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+SolarLightingTable::SolarLightingTable()
+    : _airportCount(0),
+      _cache(std::make_shared<Cache>())
+{
+}
+
+// ----------------------------------------------------------------------------
+
+SolarLightingTable::SolarLightingTable(const CSV::File &base)
+    : _airportCount(0),
+      _cache(std::make_shared<Cache>())
+{
+    if (!base.isValid())
+    {
+        return;
+    }
+
+    const CSV::Column latitudes = base.getColumn("LAT_DECIMAL");
+    const CSV::Column longitudes = base.getColumn("LONG_DECIMAL");
+    const CSV::Column runwaySchedules = base.getColumn("LGT_SKED");
+    const CSV::Column beaconSchedules = base.getColumn("BCN_LGT_SKED");
+    _airportCount = latitudes.get().size();
+    for (size_t row = 0; row < _airportCount; row++)
+    {
+        const uint8_t schedules = (Detail::IsSunsetSunrise(runwaySchedules.get()[row]) ? RUNWAY_LIGHTS : 0) |
+                                  (Detail::IsSunsetSunrise(beaconSchedules.get()[row]) ? BEACON_LIGHTS : 0);
+        if (schedules == 0)
+        {
+            continue;
+        }
+
+        const tl::optional<double> latitude = CSV::Utils::ParseOptional<double>(latitudes.get()[row]);
+        const tl::optional<double> longitude = CSV::Utils::ParseOptional<double>(longitudes.get()[row]);
+        if (!latitude || !longitude)
+        {
+            continue;
+        }
+
+        _rows.push_back(static_cast<uint32_t>(row));
+        _schedules.push_back(schedules);
+        _sinLatitudes.push_back(static_cast<float>(std::sin(Geo::ToRadians(*latitude))));
+        _cosLatitudes.push_back(static_cast<float>(std::cos(Geo::ToRadians(*latitude))));
+        _longitudes.push_back(static_cast<float>(*longitude));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t SolarLightingTable::getAirportCount() const
+{
+    return _airportCount;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t SolarLightingTable::size() const
+{
+    return _rows.size();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t SolarLightingTable::getAirportRow(size_t index) const
+{
+    return _rows[index];
+}
+
+// ----------------------------------------------------------------------------
+
+uint8_t SolarLightingTable::getSchedules(size_t index) const
+{
+    return _schedules[index];
+}
+
+// ----------------------------------------------------------------------------
+
+std::shared_ptr<const SolarDay> SolarLightingTable::getSolarDay(int64_t day) const
+{
+    std::lock_guard<std::mutex> lock(_cache->mutex);
+    for (std::deque<std::shared_ptr<const SolarDay>>::iterator cached = _cache->days.begin(); cached != _cache->days.end(); ++cached)
+    {
+        if ((*cached)->day == day)
+        {
+            const std::shared_ptr<const SolarDay> found = *cached;
+            _cache->days.erase(cached);
+            _cache->days.push_front(found);
+            return found;
+        }
+    }
+
+    const std::shared_ptr<const SolarDay> computed = std::make_shared<SolarDay>(computeSolarDay(day));
+    _cache->days.push_front(computed);
+    if (_cache->days.size() > CACHED_DAYS)
+    {
+        _cache->days.pop_back();
+    }
+    return computed;
+}
+
+// ----------------------------------------------------------------------------
+
+// NOAA's low precision solar position at 12:00 UTC, with the sun's center 0.833
+// degrees below the horizon at sunrise and sunset for refraction and its radius
+SolarDay SolarLightingTable::computeSolarDay(int64_t day) const
+{
+    const double n = static_cast<double>(day - 10957); // days since 2000-01-01 12:00 UTC
+    const double meanLongitude = 280.460 + 0.9856474 * n;
+    const double meanAnomaly = Geo::ToRadians(357.528 + 0.9856003 * n);
+    const double eclipticLongitude = Geo::ToRadians(meanLongitude + 1.915 * std::sin(meanAnomaly) + 0.020 * std::sin(2.0 * meanAnomaly));
+    const double obliquity = Geo::ToRadians(23.439 - 0.0000004 * n);
+    const double declination = std::asin(std::sin(obliquity) * std::sin(eclipticLongitude));
+    const double rightAscension = Geo::ToDegrees(std::atan2(std::cos(obliquity) * std::sin(eclipticLongitude), std::cos(eclipticLongitude)));
+    const double equationOfTime = 4.0 * std::remainder(meanLongitude - rightAscension, 360.0); // minutes
+
+    const float noonAtGreenwich = static_cast<float>(720.0 - equationOfTime);
+    const float sinAltitude = static_cast<float>(std::sin(Geo::ToRadians(-0.833)));
+    const float sinDeclination = static_cast<float>(std::sin(declination));
+    const float cosDeclination = static_cast<float>(std::cos(declination));
+    const float minutesPerRadian = static_cast<float>(4.0 * 180.0 / Geo::PI);
+
+    SolarDay out;
+    out.day = day;
+    out.noon.resize(size());
+    out.halfDay.resize(size());
+    const float *sinLatitudes = _sinLatitudes.data();
+    const float *cosLatitudes = _cosLatitudes.data();
+    const float *longitudes = _longitudes.data();
+    float *noon = out.noon.data();
+    float *halfDay = out.halfDay.data();
+    for (size_t i = 0; i < out.noon.size(); i++)
+    {
+        const float cosHourAngle = (sinAltitude - sinLatitudes[i] * sinDeclination) / (cosLatitudes[i] * cosDeclination);
+        noon[i] = noonAtGreenwich - 4.0f * longitudes[i];
+        halfDay[i] = std::acos(std::min(1.0f, std::max(-1.0f, cosHourAngle))) * minutesPerRadian;
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+void SolarLightingTable::computeLighting(std::time_t utc, std::vector<uint8_t> &out) const
+{
+    out.assign(_airportCount, 0);
+    const int64_t seconds = static_cast<int64_t>(utc);
+    const int64_t day = seconds >= 0 ? seconds / 86400 : -((-seconds + 86399) / 86400);
+    const std::shared_ptr<const SolarDay> solarDay = getSolarDay(day);
+
+    // the sun is up while within halfDay of the nearest noon, whichever day it falls on
+    const float minute = static_cast<float>(seconds - day * 86400) / 60.0f;
+    for (size_t i = 0; i < _rows.size(); i++)
+    {
+        const bool sunUp = std::fabs(Detail::WrapMinutes(minute - solarDay->noon[i])) < solarDay->halfDay[i];
+        out[_rows[i]] = sunUp ? 0 : _schedules[i];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,109 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "csv.h"
+
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+// Sun times of one UTC day for the airports of a SolarLightingTable, indexed
+// like the table.  Sunrise is noon - halfDay and sunset noon + halfDay; both
+// may fall outside the day for airports far from Greenwich.
+struct SolarDay
+{
+    int64_t day;                    // days since 1970-01-01
+    std::vector<float> noon;        // minutes after 00:00 UTC
+    std::vector<float> halfDay;     // minutes, 0 in polar night and 720 in polar day
+};
+
+// ----------------------------------------------------------------------------
+
+// Airports whose runway (LGT_SKED) or beacon (BCN_LGT_SKED) lights run from
+// sunset to sunrise, packed with the sine and cosine of their latitude and
+// their longitude.  Sun times are computed for all of them at once, per UTC
+// day: the declination and equation of time are evaluated once for the day,
+// so each airport costs one arc cosine.  The most recent days are cached, and
+// copies of a table share the cache.
+class SolarLightingTable
+{
+public:
+    static constexpr uint8_t RUNWAY_LIGHTS = 1;
+    static constexpr uint8_t BEACON_LIGHTS = 2;
+    static constexpr size_t CACHED_DAYS = 4;
+
+    SolarLightingTable();
+    SolarLightingTable(const CSV::File& base);
+
+    size_t getAirportCount() const;                 // APT_BASE rows
+    size_t size() const;                            // airports with an SS-SR schedule
+    size_t getAirportRow(size_t index) const;       // APT_BASE row index
+    uint8_t getSchedules(size_t index) const;       // lights on an SS-SR schedule
+
+    // sun times of every packed airport on a UTC day, computed on first use
+    std::shared_ptr<const SolarDay> getSolarDay(int64_t day) const;
+
+    // lights of every airport at the UTC time; out is resized to getAirportCount() and holds
+    // the RUNWAY_LIGHTS and BEACON_LIGHTS on an SS-SR schedule while the sun is down there
+    void computeLighting(std::time_t utc, std::vector<uint8_t>& out) const;
+
+private:
+    SolarDay computeSolarDay(int64_t day) const;
+
+    struct Cache
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<const SolarDay>> days;   // most recent first
+    };
+
+private:
+    size_t _airportCount;
+    std::vector<uint32_t> _rows;
+    std::vector<uint8_t> _schedules;
+    std::vector<float> _sinLatitudes;
+    std::vector<float> _cosLatitudes;
+    std::vector<float> _longitudes;
+    std::shared_ptr<Cache> _cache;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
@@ -0,0 +1,347 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "spatialIndex.h"
+
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+// route legs are swept in pieces no longer than this so that the prefilter
+// boxes hug the great circle instead of covering the whole leg's extent
+constexpr double MAX_CORRIDOR_PIECE_LENGTH = 60.0;
+
+// allowance for the great circle bowing away from a straight line between
+// the ends of a piece
+constexpr double CORRIDOR_PIECE_MARGIN = 1.0;
+
+// ----------------------------------------------------------------------------
+
+Geo::BoundingBox PieceBoundingBox(const Data::LatitudeLongitude &a, const Data::LatitudeLongitude &b)
+{
+    Geo::BoundingBox box = Geo::BoundingBox::Enclosing({ a, b });
+    if (box.maxLongitude - box.minLongitude > 180.0)
+    {
+        // the short way between the two points crosses the antimeridian
+        std::swap(box.minLongitude, box.maxLongitude);
+    }
+    return box;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+SpatialIndex::SpatialIndex()
+    : _cellSize(1.0), _rows(0), _columns(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+SpatialIndex::SpatialIndex(const std::vector<Data::LatitudeLongitude> &points, double cellSize)
+    : _cellSize(cellSize), _points(points)
+{
+    _rows = static_cast<uint32_t>(std::ceil(180.0 / _cellSize));
+    _columns = static_cast<uint32_t>(std::ceil(360.0 / _cellSize));
+
+    std::vector<std::pair<uint32_t, uint32_t>> keyed;
+    keyed.reserve(_points.size());
+    for (size_t i = 0; i < _points.size(); i++)
+    {
+        const Data::LatitudeLongitude &point = _points[i];
+        if (point.valid())
+        {
+            const uint32_t key = getRow(point.getLatitude()) * _columns + getColumn(point.getLongitude());
+            keyed.emplace_back(key, static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    _keys.reserve(keyed.size());
+    _order.reserve(keyed.size());
+    _latitudes.reserve(keyed.size());
+    _longitudes.reserve(keyed.size());
+    for (const std::pair<uint32_t, uint32_t> &item : keyed)
+    {
+        _keys.push_back(item.first);
+        _order.push_back(item.second);
+        _latitudes.push_back(_points[item.second].getLatitude());
+        _longitudes.push_back(_points[item.second].getLongitude());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t SpatialIndex::size() const
+{
+    return _points.size();
+}
+
+// ----------------------------------------------------------------------------
+
+bool SpatialIndex::empty() const
+{
+    return _keys.empty();
+}
+
+// ----------------------------------------------------------------------------
+
+const Data::LatitudeLongitude &SpatialIndex::getPoint(size_t index) const
+{
+    return _points[index];
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t SpatialIndex::getRow(double latitude) const
+{
+    const double row = std::floor((latitude + 90.0) / _cellSize);
+    return static_cast<uint32_t>(std::max(0.0, std::min(row, static_cast<double>(_rows - 1))));
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t SpatialIndex::getColumn(double longitude) const
+{
+    const double column = std::floor((longitude + 180.0) / _cellSize);
+    return static_cast<uint32_t>(std::max(0.0, std::min(column, static_cast<double>(_columns - 1))));
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> SpatialIndex::queryBoundingBox(const Geo::BoundingBox &box) const
+{
+    std::vector<size_t> out;
+    forEachInBoundingBox(box, [&out](size_t index)
+    {
+        out.push_back(index);
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<SpatialHit> SpatialIndex::queryRadius(const Data::LatitudeLongitude &center, double radius) const
+{
+    std::vector<SpatialHit> out;
+    forEachInBoundingBox(Geo::BoundingBox::Around(center, radius), [&](size_t index)
+    {
+        const double distance = Geo::Distance(center, _points[index]);
+        if (distance <= radius)
+        {
+            out.push_back({ index, distance });
+        }
+    });
+    std::sort(out.begin(), out.end(), [](const SpatialHit &a, const SpatialHit &b)
+    {
+        return a.distance < b.distance;
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<CorridorHit> SpatialIndex::queryCorridor(const std::vector<Data::LatitudeLongitude> &route, double halfWidth) const
+{
+    std::vector<CorridorHit> out;
+    if (route.empty())
+    {
+        return out;
+    }
+
+    // a single waypoint degenerates into a radius query
+    if (route.size() == 1)
+    {
+        for (const SpatialHit &hit : queryRadius(route[0], halfWidth))
+        {
+            out.push_back({ hit.index, 0, 0.0, hit.distance });
+        }
+        return out;
+    }
+
+    const size_t legCount = route.size() - 1;
+    std::vector<double> legStart(legCount, 0.0);
+    std::vector<double> legLength(legCount, 0.0);
+    for (size_t leg = 0; leg < legCount; leg++)
+    {
+        legLength[leg] = Geo::Distance(route[leg], route[leg + 1]);
+        if (leg > 0)
+        {
+            legStart[leg] = legStart[leg - 1] + legLength[leg - 1];
+        }
+    }
+
+    // gather (point, leg) candidates from boxes swept along each leg
+    std::vector<std::pair<uint32_t, uint32_t>> candidates;
+    for (size_t leg = 0; leg < legCount; leg++)
+    {
+        const size_t pieces = std::max<size_t>(1, static_cast<size_t>(std::ceil(legLength[leg] / Detail::MAX_CORRIDOR_PIECE_LENGTH)));
+        Data::LatitudeLongitude pieceStart = route[leg];
+        for (size_t piece = 1; piece <= pieces; piece++)
+        {
+            const Data::LatitudeLongitude pieceEnd = piece == pieces ? route[leg + 1] : Geo::Intermediate(route[leg], route[leg + 1], static_cast<double>(piece) / pieces);
+            const Geo::BoundingBox box = Detail::PieceBoundingBox(pieceStart, pieceEnd).expanded(halfWidth + Detail::CORRIDOR_PIECE_MARGIN);
+            forEachInBoundingBox(box, [&](size_t index)
+            {
+                candidates.emplace_back(static_cast<uint32_t>(index), static_cast<uint32_t>(leg));
+            });
+            pieceStart = pieceEnd;
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // keep the closest qualifying leg for each point
+    for (size_t i = 0; i < candidates.size();)
+    {
+        const uint32_t index = candidates[i].first;
+        const Data::LatitudeLongitude &point = _points[index];
+        bool found = false;
+        CorridorHit best{ index, 0, 0.0, 0.0 };
+        double bestDistance = 0.0;
+
+        for (; i < candidates.size() && candidates[i].first == index; i++)
+        {
+            const size_t leg = candidates[i].second;
+            const Data::LatitudeLongitude &start = route[leg];
+            const Data::LatitudeLongitude &end = route[leg + 1];
+
+            double alongTrack = 0.0;
+            double crossTrack = 0.0;
+            double distance = 0.0;
+            if (legLength[leg] < 1e-9)
+            {
+                distance = crossTrack = Geo::Distance(point, start);
+            }
+            else
+            {
+                alongTrack = Geo::AlongTrackDistance(point, start, end);
+                crossTrack = Geo::CrossTrackDistance(point, start, end);
+                if (alongTrack < 0.0)
+                {
+                    alongTrack = 0.0;
+                    distance = Geo::Distance(point, start);
+                }
+                else if (alongTrack > legLength[leg])
+                {
+                    alongTrack = legLength[leg];
+                    distance = Geo::Distance(point, end);
+                }
+                else
+                {
+                    distance = std::abs(crossTrack);
+                }
+            }
+
+            if (distance <= halfWidth && (!found || distance < bestDistance))
+            {
+                found = true;
+                bestDistance = distance;
+                best = { index, leg, legStart[leg] + alongTrack, crossTrack };
+            }
+        }
+
+        if (found)
+        {
+            out.push_back(best);
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](const CorridorHit &a, const CorridorHit &b)
+    {
+        return a.alongTrackDistance < b.alongTrackDistance;
+    });
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<size_t> SpatialIndex::queryPolygon(const Geo::Polygon &polygon) const
+{
+    std::vector<size_t> out;
+    if (polygon.empty())
+    {
+        return out;
+    }
+
+    std::vector<uint8_t> inside;
+    forEachSpanInBoundingBox(polygon.getBoundingBox(), [&](const uint32_t *indices, const double *latitudes, const double *longitudes, size_t count)
+    {
+        inside.resize(count);
+        polygon.contains(latitudes, longitudes, count, inside.data());
+        for (size_t i = 0; i < count; i++)
+        {
+            if (inside[i])
+            {
+                out.push_back(indices[i]);
+            }
+        }
+    });
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<SpatialPair> SpatialIndex::selfJoin(double distance, size_t threads) const
+{
+    return selfJoinWhere(distance, [](size_t, size_t)
+    {
+        return true;
+    }, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<SpatialPair> SpatialIndex::selfJoinOnKey(double distance, const std::vector<std::string> &keys, size_t threads) const
+{
+    return selfJoinWhere(distance, [&keys](size_t first, size_t second)
+    {
+        return !keys[first].empty() && keys[first] == keys[second];
+    }, threads);
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
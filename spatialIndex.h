@@ -0,0 +1,244 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "data.h"
+#include "geo.h"
+#include "parallel.h"
+#include "polygon.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+struct SpatialHit
+{
+    size_t index;
+    double distance;
+};
+
+// ----------------------------------------------------------------------------
+
+struct CorridorHit
+{
+    size_t index;
+    size_t leg;
+    double alongTrackDistance;
+    double crossTrackDistance;
+};
+
+// ----------------------------------------------------------------------------
+
+struct SpatialPair
+{
+    size_t first;  // always the lower of the two indices
+    size_t second;
+    double distance;
+};
+
+// ----------------------------------------------------------------------------
+
+// Uniform latitude/longitude grid over a packed array of points.  Points are
+// stored sorted by cell so that each grid row of a query is a single binary
+// search followed by a contiguous scan.  Indices returned by queries refer to
+// the position of the point in the vector passed to the constructor; invalid
+// points are not indexed.
+class SpatialIndex
+{
+public:
+    SpatialIndex();
+    SpatialIndex(const std::vector<Data::LatitudeLongitude>& points, double cellSize = 0.5);
+
+    size_t size() const;
+    bool empty() const;
+    const Data::LatitudeLongitude& getPoint(size_t index) const;
+
+    std::vector<size_t> queryBoundingBox(const Geo::BoundingBox& box) const;
+    std::vector<SpatialHit> queryRadius(const Data::LatitudeLongitude& center, double radius) const;
+    std::vector<CorridorHit> queryCorridor(const std::vector<Data::LatitudeLongitude>& route, double halfWidth) const;
+    std::vector<size_t> queryPolygon(const Geo::Polygon& polygon) const;
+
+    // every pair of points no more than distance apart, sorted by (first, second)
+    std::vector<SpatialPair> selfJoin(double distance, size_t threads = 0) const;
+
+    // as selfJoin, but only pairs whose keys (indexed like the constructor's points) are equal;
+    // points with an empty key never match
+    std::vector<SpatialPair> selfJoinOnKey(double distance, const std::vector<std::string>& keys, size_t threads = 0) const;
+
+    // as selfJoin, but only pairs for which predicate(first, second) returns true;
+    // the points are partitioned by grid cell and each partition is joined on its own thread
+    template <typename TPredicate>
+    std::vector<SpatialPair> selfJoinWhere(double distance, TPredicate predicate, size_t threads = 0) const
+    {
+        std::vector<std::vector<SpatialPair>> partials(Parallel::GetThreadCount(threads));
+        Parallel::For(_order.size(), partials.size(), [&](size_t begin, size_t end, size_t thread)
+        {
+            std::vector<SpatialPair> &local = partials[thread];
+            for (size_t i = begin; i < end; i++)
+            {
+                const size_t first = _order[i];
+                const double latitude = _latitudes[i];
+                const double longitude = _longitudes[i];
+                forEachInBoundingBox(Geo::BoundingBox::Around(_points[first], distance), [&](size_t second)
+                {
+                    if (second <= first)
+                    {
+                        return;
+                    }
+                    const double between = Geo::Distance(latitude, longitude, _points[second].getLatitude(), _points[second].getLongitude());
+                    if (between <= distance && predicate(first, second))
+                    {
+                        local.push_back({ first, second, between });
+                    }
+                });
+            }
+        });
+
+        std::vector<SpatialPair> out;
+        for (const std::vector<SpatialPair> &local : partials)
+        {
+            out.insert(out.end(), local.begin(), local.end());
+        }
+        std::sort(out.begin(), out.end(), [](const SpatialPair &a, const SpatialPair &b)
+        {
+            return a.first < b.first || (a.first == b.first && a.second < b.second);
+        });
+        return out;
+    }
+
+    template <typename TCallback>
+    void forEachInBoundingBox(const Geo::BoundingBox& box, TCallback callback) const
+    {
+        if (box.wrapsAntimeridian())
+        {
+            forEachInRange(box.minLatitude, box.maxLatitude, box.minLongitude, 180.0, callback);
+            forEachInRange(box.minLatitude, box.maxLatitude, -180.0, box.maxLongitude, callback);
+        }
+        else
+        {
+            forEachInRange(box.minLatitude, box.maxLatitude, box.minLongitude, box.maxLongitude, callback);
+        }
+    }
+
+    // visits the packed, cell-sorted coordinates of every grid cell overlapping the box as
+    // contiguous spans: callback(const uint32_t* indices, const double* latitudes, const double* longitudes, size_t count);
+    // spans may include points just outside the box
+    template <typename TCallback>
+    void forEachSpanInBoundingBox(const Geo::BoundingBox& box, TCallback callback) const
+    {
+        if (box.wrapsAntimeridian())
+        {
+            forEachSpanInRange(box.minLatitude, box.maxLatitude, box.minLongitude, 180.0, callback);
+            forEachSpanInRange(box.minLatitude, box.maxLatitude, -180.0, box.maxLongitude, callback);
+        }
+        else
+        {
+            forEachSpanInRange(box.minLatitude, box.maxLatitude, box.minLongitude, box.maxLongitude, callback);
+        }
+    }
+
+private:
+    uint32_t getRow(double latitude) const;
+    uint32_t getColumn(double longitude) const;
+
+    template <typename TCallback>
+    void forEachInRange(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TCallback& callback) const
+    {
+        if (_keys.empty())
+        {
+            return;
+        }
+
+        const uint32_t firstColumn = getColumn(minLongitude);
+        const uint32_t lastColumn = getColumn(maxLongitude);
+        for (uint32_t row = getRow(minLatitude); row <= getRow(maxLatitude); row++)
+        {
+            const uint32_t rowKey = row * _columns;
+            std::vector<uint32_t>::const_iterator first = std::lower_bound(_keys.begin(), _keys.end(), rowKey + firstColumn);
+            std::vector<uint32_t>::const_iterator last = std::upper_bound(first, _keys.end(), rowKey + lastColumn);
+            for (size_t i = first - _keys.begin(), end = last - _keys.begin(); i < end; i++)
+            {
+                const double latitude = _latitudes[i];
+                const double longitude = _longitudes[i];
+                if (latitude >= minLatitude && latitude <= maxLatitude && longitude >= minLongitude && longitude <= maxLongitude)
+                {
+                    callback(static_cast<size_t>(_order[i]));
+                }
+            }
+        }
+    }
+
+    template <typename TCallback>
+    void forEachSpanInRange(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TCallback& callback) const
+    {
+        if (_keys.empty())
+        {
+            return;
+        }
+
+        const uint32_t firstColumn = getColumn(minLongitude);
+        const uint32_t lastColumn = getColumn(maxLongitude);
+        for (uint32_t row = getRow(minLatitude); row <= getRow(maxLatitude); row++)
+        {
+            const uint32_t rowKey = row * _columns;
+            std::vector<uint32_t>::const_iterator first = std::lower_bound(_keys.begin(), _keys.end(), rowKey + firstColumn);
+            std::vector<uint32_t>::const_iterator last = std::upper_bound(first, _keys.end(), rowKey + lastColumn);
+            const size_t begin = first - _keys.begin();
+            if (last != first)
+            {
+                callback(&_order[begin], &_latitudes[begin], &_longitudes[begin], static_cast<size_t>(last - first));
+            }
+        }
+    }
+
+private:
+    double _cellSize;
+    uint32_t _rows;
+    uint32_t _columns;
+    std::vector<Data::LatitudeLongitude> _points;
+
+    // parallel arrays sorted by cell key
+    std::vector<uint32_t> _keys;
+    std::vector<uint32_t> _order;
+    std::vector<double> _latitudes;
+    std::vector<double> _longitudes;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
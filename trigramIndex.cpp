@@ -0,0 +1,363 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "trigramIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+namespace Detail
+{
+
+// ----------------------------------------------------------------------------
+
+constexpr char WORD_BOUNDARY = '\x01';
+
+// ----------------------------------------------------------------------------
+
+uint32_t PackTrigram(char a, char b, char c)
+{
+    return (static_cast<uint32_t>(static_cast<uint8_t>(a)) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) | static_cast<uint32_t>(static_cast<uint8_t>(c));
+}
+
+// ----------------------------------------------------------------------------
+
+// trigrams of the text itself plus the padded word-prefix grams used for short queries
+void CollectTrigrams(const std::string &text, std::vector<uint32_t> &out)
+{
+    for (size_t i = 0; i + 3 <= text.size(); i++)
+    {
+        out.push_back(PackTrigram(text[i], text[i + 1], text[i + 2]));
+    }
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] != ' ' && (i == 0 || text[i - 1] == ' '))
+        {
+            out.push_back(PackTrigram(WORD_BOUNDARY, WORD_BOUNDARY, text[i]));
+            if (i + 1 < text.size() && text[i + 1] != ' ')
+            {
+                out.push_back(PackTrigram(WORD_BOUNDARY, text[i], text[i + 1]));
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool IsWordStart(const std::string &text, size_t position)
+{
+    return position == 0 || text[position - 1] == ' ';
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Detail
+
+// ----------------------------------------------------------------------------
+
+TrigramIndex::TrigramIndex()
+    : _rows(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+TrigramIndex::TrigramIndex(const std::vector<std::vector<std::string>> &fields, const std::vector<double> &weights)
+    : _rows(fields.empty() ? 0 : fields[0].size()), _weights(weights)
+{
+    _weights.resize(fields.size(), 1.0);
+    _texts.resize(fields.size());
+
+    // (gram, row) pairs, sorted so that each gram's rows come out ascending
+    std::vector<uint64_t> pairs;
+    std::vector<uint32_t> grams;
+    for (size_t field = 0; field < fields.size(); field++)
+    {
+        _texts[field].reserve(_rows);
+        for (size_t row = 0; row < _rows; row++)
+        {
+            _texts[field].push_back(Normalize(fields[field][row]));
+            grams.clear();
+            Detail::CollectTrigrams(_texts[field].back(), grams);
+            for (uint32_t gram : grams)
+            {
+                pairs.push_back((static_cast<uint64_t>(gram) << 32) | row);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    for (size_t i = 0; i < pairs.size();)
+    {
+        const uint32_t gram = static_cast<uint32_t>(pairs[i] >> 32);
+        PostingList list{ gram, static_cast<uint32_t>(_postings.size()), 0 };
+        uint32_t previous = 0;
+        for (; i < pairs.size() && static_cast<uint32_t>(pairs[i] >> 32) == gram; i++)
+        {
+            const uint32_t row = static_cast<uint32_t>(pairs[i]);
+            uint32_t delta = row - previous;
+            previous = row;
+            while (delta >= 0x80)
+            {
+                _postings.push_back(static_cast<uint8_t>(delta | 0x80));
+                delta >>= 7;
+            }
+            _postings.push_back(static_cast<uint8_t>(delta));
+            list.count++;
+        }
+        _lists.push_back(list);
+    }
+    _postings.shrink_to_fit();
+}
+
+// ----------------------------------------------------------------------------
+
+size_t TrigramIndex::size() const
+{
+    return _rows;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t TrigramIndex::getMemoryUsage() const
+{
+    size_t out = _postings.capacity() + _lists.capacity() * sizeof(PostingList);
+    for (const std::vector<std::string> &field : _texts)
+    {
+        for (const std::string &text : field)
+        {
+            out += sizeof(std::string) + text.capacity();
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+std::string TrigramIndex::Normalize(const std::string &text)
+{
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text)
+    {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u))
+        {
+            out.push_back(static_cast<char>(std::toupper(u)));
+        }
+        else if (!out.empty() && out.back() != ' ')
+        {
+            out.push_back(' ');
+        }
+    }
+    if (!out.empty() && out.back() == ' ')
+    {
+        out.pop_back();
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+const TrigramIndex::PostingList *TrigramIndex::findPostingList(uint32_t gram) const
+{
+    std::vector<PostingList>::const_iterator search = std::lower_bound(_lists.begin(), _lists.end(), gram, [](const PostingList &list, uint32_t value)
+    {
+        return list.gram < value;
+    });
+    return search != _lists.end() && search->gram == gram ? &*search : nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+void TrigramIndex::decode(const PostingList &list, std::vector<uint32_t> &out) const
+{
+    out.clear();
+    out.reserve(list.count);
+    const uint8_t *data = _postings.data() + list.offset;
+    uint32_t row = 0;
+    for (uint32_t i = 0; i < list.count; i++)
+    {
+        uint32_t delta = 0;
+        int shift = 0;
+        uint8_t byte = 0;
+        do
+        {
+            byte = *data++;
+            delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        row += delta;
+        out.push_back(row);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+double TrigramIndex::score(const std::string &text, size_t position, size_t queryLength, double weight) const
+{
+    double out = weight;
+    if (position == 0)
+    {
+        out += 1.0;
+    }
+    else if (Detail::IsWordStart(text, position))
+    {
+        out += 0.5;
+    }
+    if (queryLength == text.size())
+    {
+        out += 1.0;
+    }
+
+    // favour shorter texts where the query covers more of the value
+    return out + 0.5 * static_cast<double>(queryLength) / static_cast<double>(text.size());
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<TextSearchResult> TrigramIndex::search(const std::string &query, TextMatch mode, size_t limit) const
+{
+    std::vector<TextSearchResult> out;
+    const std::string normalized = Normalize(query);
+    if (normalized.empty())
+    {
+        return out;
+    }
+
+    // queries shorter than a trigram can only be answered as word prefixes
+    const bool wordPrefix = mode == TextMatch::PREFIX || normalized.size() < 3;
+    std::vector<uint32_t> grams;
+    if (normalized.size() == 1)
+    {
+        grams.push_back(Detail::PackTrigram(Detail::WORD_BOUNDARY, Detail::WORD_BOUNDARY, normalized[0]));
+    }
+    else if (normalized.size() == 2)
+    {
+        grams.push_back(Detail::PackTrigram(Detail::WORD_BOUNDARY, normalized[0], normalized[1]));
+    }
+    else
+    {
+        for (size_t i = 0; i + 3 <= normalized.size(); i++)
+        {
+            grams.push_back(Detail::PackTrigram(normalized[i], normalized[i + 1], normalized[i + 2]));
+        }
+        if (wordPrefix && normalized[1] != ' ')
+        {
+            grams.push_back(Detail::PackTrigram(Detail::WORD_BOUNDARY, normalized[0], normalized[1]));
+        }
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    // intersect posting lists starting from the rarest
+    std::vector<const PostingList *> lists;
+    for (uint32_t gram : grams)
+    {
+        const PostingList *list = findPostingList(gram);
+        if (list == nullptr)
+        {
+            return out;
+        }
+        lists.push_back(list);
+    }
+    std::sort(lists.begin(), lists.end(), [](const PostingList *a, const PostingList *b)
+    {
+        return a->count < b->count;
+    });
+
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> merged;
+    decode(*lists[0], candidates);
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+    {
+        decode(*lists[i], next);
+        merged.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), next.begin(), next.end(), std::back_inserter(merged));
+        candidates.swap(merged);
+    }
+
+    // trigrams only narrow the candidates; confirm the match and score it
+    for (uint32_t row : candidates)
+    {
+        bool found = false;
+        TextSearchResult best{ row, 0, 0.0 };
+        for (size_t field = 0; field < _texts.size(); field++)
+        {
+            const std::string &text = _texts[field][row];
+            for (size_t position = text.find(normalized); position != std::string::npos; position = text.find(normalized, position + 1))
+            {
+                if (wordPrefix && !Detail::IsWordStart(text, position))
+                {
+                    continue;
+                }
+                const double value = score(text, position, normalized.size(), _weights[field]);
+                if (!found || value > best.score)
+                {
+                    found = true;
+                    best.field = field;
+                    best.score = value;
+                }
+            }
+        }
+        if (found)
+        {
+            out.push_back(best);
+        }
+    }
+
+    const auto ranking = [](const TextSearchResult &a, const TextSearchResult &b)
+    {
+        return a.score > b.score || (a.score == b.score && a.row < b.row);
+    };
+    if (limit != 0 && limit < out.size())
+    {
+        std::partial_sort(out.begin(), out.begin() + limit, out.end(), ranking);
+        out.resize(limit);
+    }
+    else
+    {
+        std::sort(out.begin(), out.end(), ranking);
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR
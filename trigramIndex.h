@@ -0,0 +1,104 @@
+/*
+
+Copyright 2022-2023, Aechelon Technology, Inc.
+
+Redistribution and use in source and binary forms, with or without modification
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NASR
+{
+
+// ----------------------------------------------------------------------------
+
+enum class TextMatch
+{
+    SUBSTRING,
+    PREFIX // the query must start at the beginning of a word
+};
+
+// ----------------------------------------------------------------------------
+
+struct TextSearchResult
+{
+    size_t row;
+    size_t field;  // the field that produced the best match
+    double score;
+};
+
+// ----------------------------------------------------------------------------
+
+// Case-insensitive trigram index over one or more text fields of a set of
+// rows.  Text is normalized to upper-case letters, digits and single spaces,
+// and every word is padded with two leading boundary markers so that one and
+// two character queries can still be answered as word prefixes.  Posting
+// lists are sorted row numbers stored as variable-length deltas.
+class TrigramIndex
+{
+public:
+    TrigramIndex();
+
+    // fields[f][row] holds the text of field f for each row; weights[f] scales matches in field f
+    TrigramIndex(const std::vector<std::vector<std::string>>& fields, const std::vector<double>& weights);
+
+    size_t size() const;
+    size_t getMemoryUsage() const;
+
+    // matching rows ranked by descending score; a limit of zero returns every match.
+    // Queries shorter than three characters are always matched as word prefixes.
+    std::vector<TextSearchResult> search(const std::string& query, TextMatch mode = TextMatch::SUBSTRING, size_t limit = 20) const;
+
+    static std::string Normalize(const std::string& text);
+
+private:
+    struct PostingList
+    {
+        uint32_t gram;
+        uint32_t offset; // into _postings
+        uint32_t count;
+    };
+
+    const PostingList* findPostingList(uint32_t gram) const;
+    void decode(const PostingList& list, std::vector<uint32_t>& out) const;
+    double score(const std::string& text, size_t position, size_t queryLength, double weight) const;
+
+private:
+    size_t _rows;
+    std::vector<double> _weights;
+    std::vector<std::vector<std::string>> _texts; // normalized, [field][row]
+    std::vector<PostingList> _lists;              // sorted by gram
+    std::vector<uint8_t> _postings;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace NASR